@@ -0,0 +1,54 @@
+#ifndef CallGraph_h
+#define CallGraph_h
+
+/*!
+
+   @header CallGraph
+
+   The call graph of the program: an edge from a function to another one is added
+   for each function call found while the program is parsed. Functions are identified
+   by their label index. Once the program is optimized, the edges are replaced by the
+   calls left in its intermediate code, and each function is summarized from them.
+
+   @author agent
+   @updated 2026-10-19
+
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "IntegerList.h"
+#include "IntermediateCode.h"
+#include "CompilerOptions.h"
+
+// Stack depth of a function which may call itself
+#define UNBOUNDED_STACK_DEPTH -1
+
+// Add a call from caller to callee
+void addCallGraphEdge(int caller, int callee);
+
+// Remove the call from caller to callee, once the optimizer has removed all of them
+void removeCallGraphEdge(int caller, int callee);
+
+// Returns 1 if the function is part of a cycle of the call graph, so it may be active more than once at the same time
+int isRecursiveFunction(int function);
+
+// Returns 1 if calling the first function may lead to a call of the second one (or if both are the same)
+int canReachFunction(int function, int target);
+
+// Replaces the edges by the calls left in the intermediate code of the functions
+void updateCallGraph(IntermediateFunction* functions);
+
+// Returns the words of the stack used by a call of the function, assuming the functions of each cycle of the call
+// graph are active at most recursionDepth times at once (UNBOUNDED_STACK_DEPTH if the call may recurse and recursionDepth is 0).
+// The depths of all the functions are computed at once, and kept until the graph changes.
+int getMaxStackDepth(int function, int recursionDepth);
+
+// Computes the summary of the function from the call graph (the pure functions must be marked already)
+void summarizeFunction(int function, FunctionSummary* summary);
+
+// Prints the call graph, with the summary kept with the symbol of each function (computed for the functions without one)
+void dumpCallGraph(IntermediateFunction* functions);
+
+#endif /* CallGraph_h */
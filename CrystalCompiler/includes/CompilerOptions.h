@@ -0,0 +1,108 @@
+#ifndef CompilerOptions_h
+#define CompilerOptions_h
+
+/*!
+
+   @header CompilerOptions
+
+   Options given in the command line, which select the code generation modes and optimizations.
+
+   @author agent
+   @updated 2026-10-19
+
+ */
+
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Default code size budget of the inline variable accessors (in bytes)
+#define DEFAULT_INLINE_ACCESSORS_BUDGET 1024
+
+// Default size limits of the specialized functions, and of all of them together (in intermediate instructions)
+#define DEFAULT_SPECIALIZATION_LIMIT 64
+#define DEFAULT_SPECIALIZATION_GROWTH 256
+
+// Default number of intermediate instructions run by the compile-time evaluation of a call
+#define DEFAULT_EVALUATION_LIMIT 10000
+
+// Default number of arguments whose values are kept by a memoized function
+#define DEFAULT_MEMOIZATION_TABLE_SIZE 32
+
+// Default loop unrolling factor, and largest unrolled loop body (in intermediate instructions)
+#define DEFAULT_UNROLL_FACTOR 4
+#define DEFAULT_UNROLL_LIMIT 64
+
+// Default size limits of the inlined functions (in intermediate instructions)
+#define DEFAULT_INLINE_LIMIT 12
+#define DEFAULT_INLINE_SINGLE_CALL_LIMIT 64
+
+typedef struct {
+
+    // Variables of dynamic activation records are accessed by inline code instead of errd/erwrt,
+    // while the inline accessors take at most inlineAccessorsBudget bytes and leave the memory of the stack
+    int inlineAccessors;
+    int inlineAccessorsBudget;
+
+    // Functions with dynamic activation records receive their first scalar argument in evarg, return their
+    // scalar value in evret and keep the return address in their label
+    int lightCalls;
+
+    // Array indexes are checked against the dimension sizes at run time, jumping to erbnd when they are out of
+    // bounds (the optimizer removes the checks proven redundant by its value range analysis)
+    int boundsCheck;
+
+    // Pure recursive functions of a single scalar parameter keep the values they return for the arguments in
+    // [0, memoizationTableSize) in static tables, and return them without running their body again (the tables are
+    // reduced if they do not fit in the memory left by the program)
+    int memoize;
+    int memoizationTableSize;
+
+    // Functions of a cycle of the call graph are active at most recursionDepth times at once, so the stack is sized for it
+    // (0: the stack of recursive programs takes the memory left after the program)
+    int recursionDepth;
+
+    // Optimization level (-O0 to -O3): the global optimizations of the intermediate code run from level 1,
+    // the loop optimizations, function inlining, specialization and compile-time evaluation from level 2 and loop unrolling at level 3
+    int optimizationLevel;
+
+    // Code size mode (-Os): the program is optimized as with -O2, and the instruction sequences repeated in the
+    // generated code are outlined into shared subroutines
+    int optimizeSize;
+
+    // Loops with a known trip count are fully unrolled if their unrolled body takes at most unrollLimit
+    // instructions, otherwise their body is repeated unrollFactor times
+    int unrollFactor;
+    int unrollLimit;
+
+    // Calls to non-recursive functions of at most inlineLimit instructions are inlined, and so is the only call of
+    // a function of at most inlineSingleCallLimit instructions
+    int inlineLimit;
+    int inlineSingleCallLimit;
+
+    // Functions of at most specializationLimit instructions called with literal arguments are copied for those
+    // constants (from level 2), if the copy gets smaller and all the copies take at most specializationGrowth instructions
+    int specializationLimit;
+    int specializationGrowth;
+
+    // Calls of pure functions whose arguments are all constant are run at compile time (from level 2) and replaced
+    // by their value if they return within evaluationLimit instructions
+    int evaluationLimit;
+
+    // Statistics of the optimizations are printed
+    int showStatistics;
+
+    // The call graph and the summary of each function are printed
+    int dumpCallGraph;
+
+} CompilerOptions;
+
+// Options of the current compilation
+extern CompilerOptions compilerOptions;
+
+// Reads the options in the command line arguments. The remaining arguments (input and output files) are
+// placed in files. Returns 0 if an option is invalid or if the files are missing, 1 otherwise.
+int parseCompilerOptions(int argc, const char* argv[], const char* files[2]);
+
+#endif /* CompilerOptions_h */
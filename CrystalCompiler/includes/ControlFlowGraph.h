@@ -0,0 +1,98 @@
+#ifndef ControlFlowGraph_h
+#define ControlFlowGraph_h
+
+/*!
+
+   @header ControlFlowGraph
+
+   Control flow graph of the intermediate code of a function: basic blocks, their edges and dominators.
+   The graph may also be put in static single assignment (SSA) form. Each activation record slot accessed
+   only as a scalar is a variable of the SSA form; its definitions and uses are numbered in the instructions
+   themselves (resultValue, leftValue and rightValue) and phi functions are placed at the beginning of the
+   blocks. The intermediate code still refers to slots, so the SSA form is an overlay: dropping it only
+   requires that a use is never rewritten to a value which is not the one its slot holds at that point.
+
+   @author agent
+   @updated 2026-10-19
+
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "IntermediateCode.h"
+
+// No SSA value (operand is not a variable of the SSA form)
+#define NO_VALUE -1
+
+// Phi function: value of the slot at the beginning of a block, given the value coming from each predecessor
+typedef struct {
+    int slot;
+    int value;
+    int* arguments;
+} PhiFunction;
+
+// Basic block: sequence of instructions with a single entry (first one) and a single exit (last one)
+typedef struct {
+    IntermediateInstruction* firstInstruction;
+    IntermediateInstruction* lastInstruction;
+    int* predecessors;
+    int predecessorCount;
+    int successors[2];
+    int successorCount;
+    int immediateDominator;
+    int isReachable;
+    PhiFunction* phiFunctions;
+    int phiFunctionCount;
+} BasicBlock;
+
+// SSA value: defined at the entry of the function, by an instruction or by a phi function
+typedef struct {
+    int slot;
+    int block;
+    IntermediateInstruction* definition;
+    int phiFunction;
+} SSAValue;
+
+typedef struct {
+    IntermediateFunction* function;
+
+    // Blocks in program order. Block 0 is an empty entry block, the others hold the instructions of the function.
+    // Reachable blocks are listed in reverse postorder.
+    BasicBlock* blocks;
+    int blockCount;
+    int* reversePostorder;
+    int reachableBlockCount;
+
+    // SSA form
+    int slotCount;
+    char* isSSASlot;
+    SSAValue* values;
+    int valueCount;
+} ControlFlowGraph;
+
+// Builds the graph of the function with its dominators
+ControlFlowGraph* buildControlFlowGraph(IntermediateFunction* function);
+
+// Puts the graph in SSA form
+void buildStaticSingleAssignmentForm(ControlFlowGraph* graph);
+
+// Returns 1 if block dominates otherBlock
+int dominates(ControlFlowGraph* graph, int block, int otherBlock);
+
+// Returns 1 if the block is the target of a back edge (an edge from a block it dominates)
+int isLoopHeader(ControlFlowGraph* graph, int block);
+
+// Marks in isLoopBlock (one entry per block) the blocks of the natural loop of the header
+void findNaturalLoop(ControlFlowGraph* graph, int header, char* isLoopBlock);
+
+// Returns the instruction following the last one of the block (NULL for the entry block), which ends iterations
+IntermediateInstruction* getBlockEnd(BasicBlock* block);
+
+// Returns the block whose first instruction is the given one, -1 if there is none
+int getBlockStartingAt(ControlFlowGraph* graph, IntermediateInstruction* instruction);
+
+void freeControlFlowGraph(ControlFlowGraph* graph);
+
+#endif /* ControlFlowGraph_h */
@@ -0,0 +1,30 @@
+#ifndef Inliner_h
+#define Inliner_h
+
+/*!
+
+   @header Inliner
+
+   Function inlining: calls to small non-recursive functions, and the only call of larger ones, are
+   replaced by a copy of the body of the called function. Its activation record becomes a part of the
+   activation record of the caller, the arguments are copied to the slots of its parameters and its
+   returns jump to the instruction following the call, after copying the returned value to the result
+   of the call.
+
+   @author agent
+   @updated 2026-10-19
+
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "IntermediateCode.h"
+#include "CallGraph.h"
+#include "CompilerOptions.h"
+
+// Inlines the calls of the program which fit the size limits of the compiler options. Returns the number of
+// inlined calls.
+int inlineFunctionCalls(IntermediateFunction* functions);
+
+#endif /* Inliner_h */
@@ -0,0 +1,146 @@
+#ifndef IntermediateCode_h
+#define IntermediateCode_h
+
+/*!
+
+   @header IntermediateCode
+
+   The semantic functions record the code of each function as a list of intermediate instructions.
+   The whole program is known before it is translated into MVN code by the code generator, which
+   allows the program to be analyzed (call graph, recursion) before the code is generated.
+
+   @author agent
+   @updated 2026-10-19
+
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "OperandStack.h"
+#include "OperatorStack.h"
+#include "SymbolTable.h"
+
+// Intermediate instruction operation
+typedef enum {
+    icAttribution,      // result = left
+    icArithmetic,       // result = left operator right
+    icRelational,       // result = left operator right
+    icLogical,          // result = left operator right
+    icAddress,          // result = address of the slot of left at address (size: number of slots of the variable)
+    icLoad,             // result = value at address left
+    icStore,            // value at address right = left
+    icBoundsCheck,      // stop the program if left is not in [0, size) (size: size of the array dimension)
+    icLabel,            // label:
+    icJump,             // jump to label
+    icJumpIfFalse,      // jump to label if left is false (left operator right with a relational operator)
+    icJumpIfTrue,       // jump to label if left is true (left operator right with a relational operator)
+    icReturn,           // return left (size: size of the returned value, 0 if there is none)
+    icParameter,        // pass left as the parameter of function at address (size: size of the parameter)
+    icFunctionCall,     // result = function() (size: size of the returned value)
+    icScan,             // read result (dataType: type of the value)
+    icPrint             // print left (dataType: type of the value)
+} IntermediateOperation;
+
+// Intermediate instruction, node of a doubly linked list
+typedef struct IntermediateInstruction {
+    IntermediateOperation operation;
+    Operator operator;
+    Operand result;
+    Operand left;
+    Operand right;
+    int label;
+    int function;
+    int address;
+    int size;
+    SymbolType dataType;
+    const char* comment;
+    int resultValue;    // SSA values of the operands (see ControlFlowGraph)
+    int leftValue;
+    int rightValue;
+    struct IntermediateInstruction* previousInstruction;
+    struct IntermediateInstruction* nextInstruction;
+} IntermediateInstruction;
+
+// Intermediate code of a function, node of a linked list in declaration order (main is the last one)
+typedef struct IntermediateFunction {
+    int index;
+    char* name;
+    int isMain;
+    int activationRecordSize;
+    int returnValueSize;
+    int firstParameterSize;
+    int labelCounter;
+    int hasStaticActivationRecord;
+    int usesLightCallingConvention;
+    int isPure;
+    int memoizedArguments;
+    int memoizationSlot;
+    int mergedFunctionCount;    // Identical functions whose calls call this one instead (-1 if it is one of them)
+    IntermediateInstruction* firstInstruction;
+    IntermediateInstruction* lastInstruction;
+    struct IntermediateFunction* nextFunction;
+} IntermediateFunction;
+
+// Functions
+int beginIntermediateFunction(char* name, int isMain);
+void endIntermediateFunction(int activationRecordSize, int returnValueSize);
+IntermediateFunction* getIntermediateFunctions();
+IntermediateFunction* getIntermediateFunction(int index);
+int newIntermediateLabel(IntermediateFunction* function);
+IntermediateFunction* copyIntermediateFunction(IntermediateFunction* function);
+void insertIntermediateFunction(IntermediateFunction* function, IntermediateFunction* previousFunction);
+void freeIntermediateFunction(IntermediateFunction* function);
+void removeIntermediateFunction(IntermediateFunction* function);
+int getIntermediateFunctionSize(IntermediateFunction* function);
+
+// Instructions
+void removeIntermediateInstruction(IntermediateFunction* function, IntermediateInstruction* instruction);
+void moveIntermediateInstruction(IntermediateFunction* function, IntermediateInstruction* instruction, IntermediateInstruction* nextInstruction);
+IntermediateInstruction* insertIntermediateInstruction(IntermediateFunction* function, IntermediateOperation operation, IntermediateInstruction* nextInstruction);
+IntermediateInstruction* copyIntermediateInstruction(IntermediateFunction* function, IntermediateInstruction* instruction, IntermediateInstruction* nextInstruction);
+int isConditionalJump(IntermediateInstruction* instruction);
+int isComparisonJump(IntermediateInstruction* instruction);
+int readsLeftOperand(IntermediateInstruction* instruction);
+int readsRightOperand(IntermediateInstruction* instruction);
+int writesResult(IntermediateInstruction* instruction);
+int getLeftOperandSize(IntermediateInstruction* instruction);
+int getResultSize(IntermediateInstruction* instruction);
+
+// Operations
+void appendAttribution(Operand leftOperand, Operand rightOperand);
+void appendOperation(IntermediateOperation operation, Operator operator, Operand leftOperand, Operand rightOperand, int resultAddressOffset);
+
+// Array elements
+void appendAddress(Operand variable, int size, int position, int resultAddressOffset);
+void offsetElementAddress(Operand address, int slots);
+void appendLoad(Operand address, int resultAddressOffset);
+void appendStore(Operand address, Operand value);
+void appendBoundsCheck(Operand index, int size);
+
+// If
+void appendIfCommand(Operand condition);
+void appendElseCommand();
+void appendEndIf();
+
+// While
+void appendWhileCommand();
+void appendWhileTest(Operand condition);
+void appendEndWhile();
+
+// For
+void appendForCondition();
+void appendForTest(Operand condition);
+void appendForStep();
+void appendEndFor();
+
+// Function call
+void appendFunctionReturn(Operand* returnOperand, int returnValueSize);
+void appendPassingParameter(Operand parameter, int functionAddress, int address, int size);
+void appendFunctionCall(int functionAddress, int resultAddressOffset, int returnValueSize);
+
+// Scan and print
+void appendScan(SymbolType type, int resultAddressOffset);
+void appendPrint(SymbolType type, Operand operand);
+
+#endif /* IntermediateCode_h */
@@ -0,0 +1,35 @@
+#ifndef Memoization_h
+#define Memoization_h
+
+/*!
+
+   @header Memoization
+
+   Purity analysis and memoization. A function is pure if its parameters are scalars, it neither scans
+   nor prints and it only calls pure functions, so the value it returns only depends on its arguments.
+   With --memoize, the pure recursive functions of a single scalar parameter keep the values they return
+   for the arguments in [0, memoizationTableSize) in a static table, next to a table of flags telling which
+   of them are already computed (see CodeGenerator, which reduces the tables to fit in the memory left by
+   the program). The offset of the entry of the argument, or a negative value if it is out of the tables,
+   is kept in a slot of the activation record until the function returns.
+
+   @author agent
+   @updated 2026-10-19
+
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "IntermediateCode.h"
+#include "CallGraph.h"
+#include "CompilerOptions.h"
+
+// Marks the pure functions of the program
+void findPureFunctions(IntermediateFunction* functions);
+
+// Marks the functions to memoize and adds the slot of their table entry to their activation record. Returns
+// the number of memoized functions.
+int memoizeFunctions(IntermediateFunction* functions);
+
+#endif /* Memoization_h */
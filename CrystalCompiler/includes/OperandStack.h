@@ -28,7 +28,10 @@ typedef enum {
     opdtBoolean,
     
     // Value = string address in string buffer
-    opdtString
+    opdtString,
+    
+    // Value = offset of the temporary variable holding the address of an array element
+    opdtElement
     
 } OperandType;
 
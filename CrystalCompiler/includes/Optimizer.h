@@ -0,0 +1,70 @@
+#ifndef Optimizer_h
+#define Optimizer_h
+
+/*!
+
+   @header Optimizer
+
+   Whatever the optimization level, the instructions following a jump or a return up to the next label
+   some jump goes to are removed, and so are the functions main can never call, before the functions are
+   optimized and again once inlining and specialization have left some of them without calls.
+   Global optimizations of the intermediate code, run on each function before code generation, after
+   the calls of functions to themselves followed by a return are turned into jumps back to the beginning
+   of their body and the calls to small functions are inlined (from level 2, see Inliner). A call whose
+   value is added to or multiplied by another one before being returned, as in n * f(n - 1), is turned
+   into a jump too, the operation being done on an accumulator which the other returns combine with their
+   value. The functions which no longer call themselves get a static activation record. From level 2,
+   the calls of pure functions (see Memoization) whose arguments are constant are run by an interpreter of
+   the intermediate code, within the evaluation step limit, and replaced by the value they return, both
+   before inlining and after constants are propagated, so the expressions using them are folded too.
+   Before a function is optimized, its calls which pass literals to functions already optimized call a
+   copy of them specialized for those constants instead (from level 2), shared by the calls passing the
+   same ones. The copy is kept if propagating the constants makes it smaller, within the size limits.
+   Each pass puts the control flow graph of the function in SSA form (see ControlFlowGraph) and
+   rewrites the intermediate instructions, so its results are lowered back simply by keeping the
+   activation record slots of the instructions:
+     - sparse conditional constant propagation (SCCP) replaces constant operands by literals,
+       folds constant branches and removes the blocks that are never executed;
+     - global value numbering (GVN) replaces redundant expressions and copies by the slot that
+       still holds their value;
+     - loop-invariant code motion (LICM, from level 2) moves the computations which give the same value
+       in every iteration of a loop to its preheader, in front of the label of the loop;
+     - loop rotation (from level 2) turns while loops into guarded do-while loops, which test their
+       condition at the bottom and jump back if it is true;
+     - loop unrolling (from level 3) repeats the body of the rotated loops whose trip count is known
+       after constant propagation: completely if it is small, or by the unroll factor otherwise, the
+       remaining iterations being run in front of the loop. Constants are propagated again afterwards;
+     - bounds check elimination (with --bounds-check) removes the array index checks whose index is
+       always within the dimension, according to a range analysis of the index: its literal, the values
+       of a loop induction variable with a known trip count, the conditional jumps taken to reach the
+       check and the checks of the same index which dominate it;
+     - strength reduction (from level 2) replaces the computations of base + induction variable * literal
+       in those loops, such as the addresses of array elements, by a slot increased in every iteration. If
+       the induction variable is then only used by the bottom test, the test compares that slot instead;
+     - dead store elimination (DSE) removes the computations whose values are never used.
+   Finally, conditional jumps on the result of a comparison compare its operands themselves, and the
+   functions whose intermediate code is identical to a previous one, calls to themselves aside, are
+   merged: their calls call the previous one instead, and the dead code elimination removes them.
+
+   @author agent
+   @updated 2026-10-19
+
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ControlFlowGraph.h"
+#include "CompilerOptions.h"
+#include "Inliner.h"
+#include "Memoization.h"
+
+// Largest literal that can be loaded by a single LV instruction
+#define MAX_IMMEDIATE_VALUE 0xfff
+
+// Optimizes the intermediate code of the functions according to the optimization level.
+// Statistics of each pass are printed if they were requested.
+void optimizeProgram(IntermediateFunction* functions);
+
+#endif /* Optimizer_h */
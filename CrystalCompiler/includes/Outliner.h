@@ -0,0 +1,32 @@
+#ifndef Outliner_h
+#define Outliner_h
+
+/*!
+
+   @header Outliner
+
+   Procedural abstraction of the generated MVN code (with -Os): the sequences of instructions repeated
+   across the program are moved to shared subroutines, and each of their occurrences is replaced by a
+   call of the subroutine (SC), which leaves the accumulator untouched. The occurrences are found by
+   sorting the sequences starting at each instruction, so the repeated ones are next to each other, and
+   the sequence saving the most words is outlined first, until none saves any.
+   Only the instructions which behave the same wherever they run can be moved: loads, stores, arithmetic
+   and calls of the environment sub-routines. Jumps, calls of functions, returns and data are left in
+   place, and a labelled instruction can only begin a sequence, its label staying on the call.
+
+   @author agent
+   @updated 2026-10-19
+
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "CompilerOptions.h"
+
+// Copies the MVN code of the program from input to output, with its repeated sequences outlined. The
+// subroutines are placed before main. Statistics are printed if they were requested.
+void outlineProgram(FILE* input, FILE* output);
+
+#endif /* Outliner_h */
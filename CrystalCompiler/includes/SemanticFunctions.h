@@ -17,6 +17,11 @@
 
 #include "SymbolTable.h"
 #include "CodeGenerator.h"
+#include "IntermediateCode.h"
+#include "CallGraph.h"
+#include "CompilerOptions.h"
+#include "Optimizer.h"
+#include "Memoization.h"
 #include "LexicalAnalyzer.h"
 #include "IntegerStack.h"
 #include "OperandStack.h"
@@ -65,6 +70,9 @@ void newOperandOrFunctionCall(int index);
 void evaluateExpression(ExpressionEvaluationTrigger trigger);
 void accessStructField(int symbolIndex);
 void accessArrayDimension(int index);
+void openArrayIndex();
+void closeArrayIndex();
+void loadArrayElement();
 
 // If
 void newIfCommand();
@@ -76,6 +84,12 @@ void newWhileCommand();
 void whileTest();
 void endWhileCommand();
 
+// For
+void forCondition();
+void forTest();
+void forStep();
+void endForCommand();
+
 // Free internal structures
 void freeSemanticAnalyzerInternalStructures();
 
@@ -46,6 +46,16 @@ typedef enum {
 } SymbolType;
 
 
+// Interprocedural facts about a function, computed from the call graph once the program is optimized
+typedef struct {
+    int isRecursive;    // Part of a cycle of the call graph
+    int isLeaf;         // Calls no function
+    int isPure;         // Only computes its returned value from its arguments
+    int maxFrameSize;   // Largest activation record of the function and of the functions it may call (in words)
+    int maxStackDepth;  // Largest stack used by a call of the function (in words), -1 if unbounded
+} FunctionSummary;
+
+
 // Symbol table row, represents a symbol in a table
 typedef struct SymbolTableRow {
     int id;
@@ -56,6 +66,8 @@ typedef struct SymbolTableRow {
     int address;
     int totalSize;
     IntegerList* dimensionSizes;
+    IntegerList* dimensionStrides;  // Slots between consecutive indexes of each dimension (row-major order)
+    FunctionSummary summary;        // Functions only
     struct SymbolTableRow* nextRow;
 } SymbolTableRow;
 
@@ -27,7 +27,7 @@ const SubAutomatonState ATOM_NEXT_STATE[ATOM_COUNT_OF_STATES][ATOM_COUNT_OF_SYMB
     {       2,       2,   7,   2,   5,   2,   6,  2,   2,     2,    2,     2  }, // State 2
     {       4,       4,   4,   4,   4,   4,   4,  4,   4,     4,    4,     4  }, // State 3
     {      -1,      -1,  -1,   1,  -1,  -1,  -1, -1,  -1,    -1,   -1,    -1  }, // State 4
-    {      -1,      -1,  -1,  -1,  -1,  -1,  -1, -1,   8,    -1,   -1,    -1  }, // State 5
+    {       8,       8,   8,   8,   8,   8,   8,  8,   8,     8,    8,     8  }, // State 5
     {      -1,      -1,  -1,  -1,  -1,  -1,  -1,  9,  -1,    -1,   -1,    -1  }, // State 6
     {       4,       4,   4,   4,   4,   4,   4,  4,   4,     4,    4,     4  }, // State 7
     {      -1,      -1,  -1,  -1,  -1,   9,  -1, -1,  -1,    -1,   -1,    -1  }, // State 8
@@ -52,7 +52,7 @@ const SubAutomatonIdentifier ATOM_SUB_AUTOMATON_CALL[ATOM_COUNT_OF_STATES][ATOM_
     {  saiFSTE, saiFSTE, saiNONE, saiFSTE, saiNONE, saiFSTE, saiNONE, saiFSTE, saiFSTE, saiFSTE, saiFSTE, saiFSTE }, // State 2
     {  saiEXPR, saiEXPR, saiEXPR, saiEXPR, saiEXPR, saiEXPR, saiEXPR, saiEXPR, saiEXPR, saiEXPR, saiEXPR, saiEXPR }, // State 3
     {  saiNONE, saiNONE, saiNONE, saiNONE, saiNONE, saiNONE, saiNONE, saiNONE, saiNONE, saiNONE, saiNONE, saiNONE }, // State 4
-    {  saiNONE, saiNONE, saiNONE, saiNONE, saiNONE, saiNONE, saiNONE, saiNONE, saiNONE, saiNONE, saiNONE, saiNONE }, // State 5
+    {  saiEXPR, saiEXPR, saiEXPR, saiEXPR, saiEXPR, saiEXPR, saiEXPR, saiEXPR, saiEXPR, saiEXPR, saiEXPR, saiEXPR }, // State 5
     {  saiNONE, saiNONE, saiNONE, saiNONE, saiNONE, saiNONE, saiNONE, saiNONE, saiNONE, saiNONE, saiNONE, saiNONE }, // State 6
     {  saiEXPS, saiEXPS, saiEXPS, saiEXPS, saiEXPS, saiEXPS, saiEXPS, saiEXPS, saiEXPS, saiEXPS, saiEXPS, saiEXPS }, // State 7
     {  saiNONE, saiNONE, saiNONE, saiNONE, saiNONE, saiNONE, saiNONE, saiNONE, saiNONE, saiNONE, saiNONE, saiNONE }, // State 8
@@ -23,7 +23,7 @@ const SubAutomatonState ATTR_NEXT_STATE[ATTR_COUNT_OF_STATES][ATTR_COUNT_OF_SYMB
     // "("  ")"  "["   "]"   "="   "."   id   int   string   other
     {   -1,  -1,  -1 ,  -1 ,  -1 ,  -1 ,  1 ,  -1 ,     -1 ,    -1  }, // State 0
     {    5,  -1,   2 ,  -1 ,   4 ,   3 , -1 ,  -1 ,     -1 ,    -1  }, // State 1
-    {   -1,  -1,  -1 ,  -1 ,  -1 ,  -1 , -1 ,   6 ,     -1 ,    -1  }, // State 2
+    {    6,   6,   6 ,   6 ,   6 ,   6 ,  6 ,   6 ,      6 ,     6  }, // State 2
     {   -1,  -1,  -1 ,  -1 ,  -1 ,  -1 ,  8 ,  -1 ,     -1 ,    -1  }, // State 3
     {    9,   9,  10 ,   9 ,   9 ,   9 ,  9 ,   9 ,      9 ,     9  }, // State 4
     {    7,   7,   7 ,   7 ,   7 ,   7 ,  7 ,   7 ,      7 ,     7  }, // State 5
@@ -50,7 +50,7 @@ const SubAutomatonIdentifier ATTR_SUB_AUTOMATON_CALL[ATTR_COUNT_OF_STATES][ATTR_
     // "("      ")"      "["      "]"      "="      "."      id       int      string   other
     {  saiNONE, saiNONE, saiNONE, saiNONE, saiNONE, saiNONE, saiNONE, saiNONE, saiNONE, saiNONE  }, // State 0
     {  saiNONE, saiNONE, saiNONE, saiNONE, saiNONE, saiNONE, saiNONE, saiNONE, saiNONE, saiNONE  }, // State 1
-    {  saiNONE, saiNONE, saiNONE, saiNONE, saiNONE, saiNONE, saiNONE, saiNONE, saiNONE, saiNONE  }, // State 2
+    {  saiEXPR, saiEXPR, saiEXPR, saiEXPR, saiEXPR, saiEXPR, saiEXPR, saiEXPR, saiEXPR, saiEXPR  }, // State 2
     {  saiNONE, saiNONE, saiNONE, saiNONE, saiNONE, saiNONE, saiNONE, saiNONE, saiNONE, saiNONE  }, // State 3
     {  saiEXPR, saiEXPR, saiNONE, saiEXPR, saiEXPR, saiEXPR, saiEXPR, saiEXPR, saiNONE, saiEXPR  }, // State 4
     {  saiEXPS, saiEXPS, saiEXPS, saiEXPS, saiEXPS, saiEXPS, saiEXPS, saiEXPS, saiEXPS, saiEXPS  }, // State 5
@@ -0,0 +1,258 @@
+/*!
+
+   CallGraph.c
+
+   Author: agent
+   Updated: 2026-10-19
+
+ */
+
+#include "CallGraph.h"
+
+// Callees of each function, indexed by the function label index
+static IntegerList** callees = NULL;
+static int functionCount = 0;
+
+// Stack depth of each function, computed for stackDepthsRecursionDepth (NULL once the graph changes)
+static int* stackDepths = NULL;
+static int stackDepthsRecursionDepth = 0;
+
+static void invalidateStackDepths() {
+    free(stackDepths);
+    stackDepths = NULL;
+}
+
+void addCallGraphEdge(int caller, int callee) {
+
+    // Grow the graph until it holds both functions
+    int requiredCount = (caller > callee ? caller : callee) + 1;
+    if (requiredCount > functionCount) {
+        callees = realloc(callees, requiredCount * sizeof(IntegerList*));
+        while (functionCount < requiredCount) callees[functionCount++] = NULL;
+    }
+
+    // Add edge only once
+    for (IntegerList* node = callees[caller]; node != NULL; node = node->nextNode) {
+        if (node->Integer == callee) return;
+    }
+    pushIntegerToList(&callees[caller], callee);
+    invalidateStackDepths();
+
+}
+
+void removeCallGraphEdge(int caller, int callee) {
+
+    if (caller >= functionCount) return;
+
+    for (IntegerList** node = &callees[caller]; *node != NULL; node = &(*node)->nextNode) {
+        if ((*node)->Integer == callee) {
+            IntegerList* removedNode = *node;
+            *node = removedNode->nextNode;
+            free(removedNode);
+            invalidateStackDepths();
+            return;
+        }
+    }
+
+}
+
+// Depth-first search for target, starting from the callees of function
+static int reachesFunction(int function, int target, char* visited) {
+
+    for (IntegerList* node = callees[function]; node != NULL; node = node->nextNode) {
+        if (node->Integer == target) return 1;
+        if (!visited[node->Integer]) {
+            visited[node->Integer] = 1;
+            if (reachesFunction(node->Integer, target, visited)) return 1;
+        }
+    }
+
+    return 0;
+
+}
+
+int isRecursiveFunction(int function) {
+
+    if (function >= functionCount) return 0;
+
+    char* visited = calloc(functionCount, sizeof(char));
+    int isRecursive = reachesFunction(function, function, visited);
+    free(visited);
+
+    return isRecursive;
+
+}
+
+int canReachFunction(int function, int target) {
+
+    if (function == target) return 1;
+    if (function >= functionCount) return 0;
+
+    char* visited = calloc(functionCount, sizeof(char));
+    int canReach = reachesFunction(function, target, visited);
+    free(visited);
+
+    return canReach;
+
+}
+
+void updateCallGraph(IntermediateFunction* functions) {
+
+    for (int function = 0; function < functionCount; function++) {
+        while (callees[function] != NULL) removeCallGraphEdge(function, callees[function]->Integer);
+    }
+
+    for (IntermediateFunction* function = functions; function != NULL; function = function->nextFunction) {
+        for (IntermediateInstruction* instruction = function->firstInstruction; instruction != NULL; instruction = instruction->nextInstruction) {
+            if (instruction->operation == icFunctionCall) addCallGraphEdge(function->index, instruction->function);
+        }
+    }
+
+}
+
+
+// FUNCTION SUMMARIES
+
+// Words of the dynamic activation record of the function (static ones are not on the stack)
+static int getDynamicFrameSize(int function) {
+    IntermediateFunction* intermediateFunction = getIntermediateFunction(function);
+    if (intermediateFunction == NULL || intermediateFunction->hasStaticActivationRecord) return 0;
+    return intermediateFunction->activationRecordSize;
+}
+
+// Search of the cycles of the call graph (Tarjan): visit order and lowest order reachable of each function,
+// and functions visited whose cycle is not complete yet
+static int* visitOrders = NULL;
+static int* lowestOrders = NULL;
+static int* openFunctions = NULL;
+static char* isOpenFunction = NULL;
+static int openFunctionCount = 0;
+static int visitCounter = 0;
+
+// Visits the function and its callees. Once a cycle (or a function out of any cycle) is complete, the depth of the
+// calls out of it is known, and so is the depth of its functions: each one takes the largest activation record of
+// the cycle, recursionDepth times, before the deepest call out of the cycle (unbounded if recursionDepth is 0).
+static void computeComponentStackDepth(int function, int recursionDepth) {
+
+    int first;
+    int isRecursive = 0;
+    int frameSize = 0;
+    int maxCalleeDepth = 0;
+    int depth;
+
+    visitOrders[function] = lowestOrders[function] = ++visitCounter;
+    openFunctions[openFunctionCount++] = function;
+    isOpenFunction[function] = 1;
+
+    for (IntegerList* node = callees[function]; node != NULL; node = node->nextNode) {
+        int callee = node->Integer;
+        if (visitOrders[callee] == 0) {
+            computeComponentStackDepth(callee, recursionDepth);
+            if (lowestOrders[callee] < lowestOrders[function]) lowestOrders[function] = lowestOrders[callee];
+        }
+        else if (isOpenFunction[callee] && visitOrders[callee] < lowestOrders[function]) lowestOrders[function] = visitOrders[callee];
+    }
+
+    // Only the first function visited of a cycle completes it
+    if (lowestOrders[function] != visitOrders[function]) return;
+
+    for (first = openFunctionCount - 1; openFunctions[first] != function; first--);
+
+    // Largest activation record of the cycle, and deepest call out of it (the open callees are in the cycle)
+    for (int member = first; member < openFunctionCount; member++) {
+        if (getDynamicFrameSize(openFunctions[member]) > frameSize) frameSize = getDynamicFrameSize(openFunctions[member]);
+        for (IntegerList* node = callees[openFunctions[member]]; node != NULL; node = node->nextNode) {
+            if (isOpenFunction[node->Integer]) isRecursive = 1;
+            else if (maxCalleeDepth != UNBOUNDED_STACK_DEPTH && (stackDepths[node->Integer] == UNBOUNDED_STACK_DEPTH || stackDepths[node->Integer] > maxCalleeDepth)) maxCalleeDepth = stackDepths[node->Integer];
+        }
+    }
+
+    if (maxCalleeDepth == UNBOUNDED_STACK_DEPTH || (isRecursive && recursionDepth <= 0)) depth = UNBOUNDED_STACK_DEPTH;
+    else depth = (isRecursive ? recursionDepth * frameSize : frameSize) + maxCalleeDepth;
+
+    while (openFunctionCount > first) {
+        int member = openFunctions[--openFunctionCount];
+        isOpenFunction[member] = 0;
+        stackDepths[member] = depth;
+    }
+
+}
+
+static void computeStackDepths(int recursionDepth) {
+
+    stackDepths = realloc(stackDepths, functionCount * sizeof(int));
+    stackDepthsRecursionDepth = recursionDepth;
+    visitOrders = calloc(functionCount, sizeof(int));
+    lowestOrders = calloc(functionCount, sizeof(int));
+    openFunctions = malloc(functionCount * sizeof(int));
+    isOpenFunction = calloc(functionCount, sizeof(char));
+    openFunctionCount = 0;
+    visitCounter = 0;
+
+    for (int function = 0; function < functionCount; function++) {
+        if (visitOrders[function] == 0) computeComponentStackDepth(function, recursionDepth);
+    }
+
+    free(visitOrders);
+    free(lowestOrders);
+    free(openFunctions);
+    free(isOpenFunction);
+
+}
+
+int getMaxStackDepth(int function, int recursionDepth) {
+
+    // Functions without calls are not in the graph
+    if (function >= functionCount) return getDynamicFrameSize(function);
+
+    if (stackDepths == NULL || stackDepthsRecursionDepth != recursionDepth) computeStackDepths(recursionDepth);
+
+    return stackDepths[function];
+
+}
+
+void summarizeFunction(int function, FunctionSummary* summary) {
+
+    summary->isRecursive = isRecursiveFunction(function);
+    summary->isLeaf = function >= functionCount || callees[function] == NULL;
+    summary->isPure = getIntermediateFunction(function)->isPure;
+    summary->maxFrameSize = getIntermediateFunction(function)->activationRecordSize;
+    summary->maxStackDepth = getMaxStackDepth(function, compilerOptions.recursionDepth);
+
+    // Largest activation record of the functions the call may lead to
+    for (IntermediateFunction* callee = getIntermediateFunctions(); callee != NULL; callee = callee->nextFunction) {
+        if (callee->activationRecordSize > summary->maxFrameSize && canReachFunction(function, callee->index)) summary->maxFrameSize = callee->activationRecordSize;
+    }
+
+}
+
+// Returns the symbol of the function (NULL for the specializations the optimizer added)
+static SymbolTableRow* getFunctionSymbol(int function) {
+    for (int index = 0; getSymbol(index, 0) != NULL; index++) {
+        SymbolTableRow* symbol = getSymbol(index, 0);
+        if (symbol->category == scFunction && symbol->address == function) return symbol;
+    }
+    return NULL;
+}
+
+void dumpCallGraph(IntermediateFunction* functions) {
+
+    printf("Call graph:\n");
+
+    for (IntermediateFunction* function = functions; function != NULL; function = function->nextFunction) {
+
+        FunctionSummary summary;
+        SymbolTableRow* symbol = getFunctionSymbol(function->index);
+
+        if (symbol != NULL) summary = symbol->summary;
+        else summarizeFunction(function->index, &summary);
+
+        printf("  f%02x %s ->", function->index, function->name);
+        for (IntegerList* node = function->index < functionCount ? callees[function->index] : NULL; node != NULL; node = node->nextNode) printf(" f%02x", node->Integer);
+        printf("\n    %s%s%s%s frame: %d words, max frame: %d words, ", summary.isRecursive ? "recursive, " : "", summary.isLeaf ? "leaf, " : "", summary.isPure ? "pure, " : "", function->hasStaticActivationRecord ? "static" : "dynamic", function->activationRecordSize, summary.maxFrameSize);
+        if (summary.maxStackDepth == UNBOUNDED_STACK_DEPTH) printf("max stack depth: unbounded\n");
+        else printf("max stack depth: %d words\n", summary.maxStackDepth);
+
+    }
+
+}
@@ -7,34 +7,281 @@
 //
 
 #include "CodeGenerator.h"
-#include "IntegerStack.h"
+#include "CompilerOptions.h"
+#include "CallGraph.h"
 #include "IntegerList.h"
+#include "Outliner.h"
 #include "LexicalAnalyzer.h"
 
 #define LABEL_SIZE 6
 #define BREAK_LINE "\n"
 #define INSTRUCTION_PADDING "        "
 
-// Output file pointer
-static FILE* outputCode;
+#define LOCATION_NAME_SIZE 16
+#define MAX_TRACKED_LOCATIONS 64
+#define UNKNOWN_VALUE -1
+#define FIRST_SYMBOLIC_VALUE 0x10000
+
+#define INLINE_ACCESSOR_SIZE 12
+
+// Internal labels of memoized functions: end of the function once the returned value is memoized, argument
+// out of the tables and beginning of the body
+#define MEMOIZED_RETURN_LABEL 0xfc
+#define MEMOIZATION_MISS_LABEL 0xfd
+#define MEMOIZATION_BODY_LABEL 0xfe
 
-// While optimization
-static int temporaryVariableAlreadyCreated = 0;
+// Words of the MVN memory (4 KB), and words taken by the execution environment linked with the program. The
+// environment checks its size (evsize, in bytes) when the program starts: both must be updated together.
+#define MEMORY_WORDS 0x800
+#define ENVIRONMENT_WORDS 0x14c
+
+// Words of code and data of the functions generated so far
+static int generatedWords = 0;
+
+// Output file pointer. With -Os the code is written to a temporary file first, and outlined into the output file.
+static FILE* outputCode;
+static FILE* outputFile;
 
 // Label management
-static IntegerStack* labelStack = NULL;
-static int functionLabelCounter = -1;
+static IntermediateFunction* currentFunction = NULL;
+static int currentFunctionIndex = -1;
 static int internalFunctionLabelCounter = -1;
 
 // String buffer
 static char stringBuffer[256][18];
 static int stringBufferCounter = 0;
 
+// Inline variable accessors: number of patch cells of the current function, code size spent so far and words of
+// the stack they must leave
+static int patchCellCounter = 0;
+static int inlineAccessorsSize = 0;
+static int inlineAccessorsStackWords = 0;
+
+// Function whose activation record has a base address known at compile time, -1 if the current one is dynamic.
+// Variables of a static activation record are accessed directly through labelled slots (sFFOOO: function FF, offset OOO).
+static int staticFrameFunction = -1;
+
+// Register cache: value known to be held by the accumulator and by memory locations (named cells
+// such as evval or evaddr, and activation record slots named "[base:offset]") since the last label.
+// Values below FIRST_SYMBOLIC_VALUE are constants, values above are symbolic (unknown but equal).
+typedef struct {
+    char name[LOCATION_NAME_SIZE];
+    int value;
+} TrackedLocation;
+
+static TrackedLocation trackedLocations[MAX_TRACKED_LOCATIONS];
+static int trackedLocationsCount = 0;
+static int accumulatorValue = UNKNOWN_VALUE;
+static int nextSymbolicValue = FIRST_SYMBOLIC_VALUE;
+
+
+// REGISTER CACHE
+
+static void invalidateRegisterCache() {
+    trackedLocationsCount = 0;
+    accumulatorValue = UNKNOWN_VALUE;
+}
+
+static int newSymbolicValue() {
+    return nextSymbolicValue++;
+}
+
+static int getLocationValue(const char* location) {
+    for (int i = 0; i < trackedLocationsCount; i++) {
+        if (strcmp(trackedLocations[i].name, location) == 0) return trackedLocations[i].value;
+    }
+    return UNKNOWN_VALUE;
+}
+
+// Returns the value of a location, binding it to a new symbolic value if nothing is known yet
+static int getOrCreateLocationValue(const char* location);
+
+static void setLocationValue(const char* location, int value) {
+
+    int i;
+    for (i = 0; i < trackedLocationsCount && strcmp(trackedLocations[i].name, location) != 0; i++);
+
+    // Forget the location
+    if (value == UNKNOWN_VALUE) {
+        if (i < trackedLocationsCount) trackedLocations[i] = trackedLocations[--trackedLocationsCount];
+        return;
+    }
+
+    // New location: if the table is full, drop the oldest entry
+    if (i == trackedLocationsCount) {
+        if (trackedLocationsCount == MAX_TRACKED_LOCATIONS) {
+            for (i = 1; i < MAX_TRACKED_LOCATIONS; i++) trackedLocations[i - 1] = trackedLocations[i];
+            trackedLocationsCount--;
+        }
+        i = trackedLocationsCount++;
+        strcpy(trackedLocations[i].name, location);
+    }
+
+    trackedLocations[i].value = value;
+
+}
+
+static int getOrCreateLocationValue(const char* location) {
+    int value = getLocationValue(location);
+    if (value == UNKNOWN_VALUE) {
+        value = newSymbolicValue();
+        setLocationValue(location, value);
+    }
+    return value;
+}
+
+// Activation record slot currently addressed by evaddr and evoffs, returns 0 if it is not known
+static int getAddressedSlot(char slot[LOCATION_NAME_SIZE]) {
+    int base = getLocationValue("evaddr");
+    int offset = getLocationValue("evoffs");
+    if (base == UNKNOWN_VALUE || offset == UNKNOWN_VALUE || offset >= FIRST_SYMBOLIC_VALUE) return 0;
+    sprintf(slot, "[%x:%x]", base, offset);
+    return 1;
+}
+
+// Forget activation record slots that may be aliased by a write to the given slot (NULL: all slots)
+static void invalidateAliasedSlots(const char* writtenSlot) {
+    size_t baseLength = writtenSlot != NULL ? strchr(writtenSlot, ':') - writtenSlot : 0;
+    for (int i = 0; i < trackedLocationsCount; i++) {
+        if (trackedLocations[i].name[0] == '[' && (writtenSlot == NULL || strncmp(trackedLocations[i].name, writtenSlot, baseLength + 1) != 0)) {
+            trackedLocations[i--] = trackedLocations[--trackedLocationsCount];
+        }
+    }
+}
+
+static int isConstantOperand(const char* operand) {
+    return operand[0] == '/';
+}
+
+// An instruction is redundant if the location it would write already holds the value it would write
+static int isRedundantInstruction(const char* mnemonic, const char* operand) {
+
+    if (accumulatorValue == UNKNOWN_VALUE) return 0;
+
+    if (strcmp(mnemonic, "LD") == 0 || strcmp(mnemonic, "MM") == 0) return getLocationValue(operand) == accumulatorValue;
+    if (strcmp(mnemonic, "LV") == 0 && isConstantOperand(operand)) return strtol(operand + 1, NULL, 16) == accumulatorValue;
+
+    return 0;
+
+}
+
+static void updateRegisterCache(const char* mnemonic, const char* operand) {
+
+    char slot[LOCATION_NAME_SIZE];
+
+    if (strcmp(mnemonic, "LD") == 0) accumulatorValue = getOrCreateLocationValue(operand);
+
+    else if (strcmp(mnemonic, "LV") == 0) accumulatorValue = isConstantOperand(operand) ? (int)strtol(operand + 1, NULL, 16) : UNKNOWN_VALUE;
+
+    else if (strcmp(mnemonic, "MM") == 0) {
+        if (accumulatorValue == UNKNOWN_VALUE) accumulatorValue = newSymbolicValue();
+        setLocationValue(operand, accumulatorValue);
+    }
+
+    else if (strcmp(mnemonic, "+") == 0 || strcmp(mnemonic, "-") == 0 || strcmp(mnemonic, "*") == 0 || strcmp(mnemonic, "/") == 0) {
+
+        int operandValue = getLocationValue(operand);
+
+        // Fold operations between known constants
+        if (accumulatorValue != UNKNOWN_VALUE && accumulatorValue < FIRST_SYMBOLIC_VALUE && operandValue != UNKNOWN_VALUE && operandValue < FIRST_SYMBOLIC_VALUE) {
+            switch (mnemonic[0]) {
+                case '+': accumulatorValue = (accumulatorValue + operandValue) & 0xffff; break;
+                case '-': accumulatorValue = (accumulatorValue - operandValue) & 0xffff; break;
+                case '*': accumulatorValue = (accumulatorValue * operandValue) & 0xffff; break;
+                default: accumulatorValue = UNKNOWN_VALUE; break;
+            }
+        } else accumulatorValue = UNKNOWN_VALUE;
+
+    }
+
+    else if (strcmp(mnemonic, "SC") == 0) {
+
+        // Read variable: evval and the accumulator receive the slot content
+        if (strcmp(operand, "errd") == 0) {
+            accumulatorValue = getAddressedSlot(slot) ? getOrCreateLocationValue(slot) : newSymbolicValue();
+            setLocationValue("evval", accumulatorValue);
+        }
+
+        // Write variable: the slot receives evval, which is left in the accumulator
+        else if (strcmp(operand, "erwrt") == 0) {
+            accumulatorValue = getOrCreateLocationValue("evval");
+            if (getAddressedSlot(slot)) {
+                invalidateAliasedSlots(slot);
+                setLocationValue(slot, accumulatorValue);
+            } else invalidateAliasedSlots(NULL);
+        }
+
+        // Output routines only use the accumulator and their own variables
+        else if (strcmp(operand, "puti") == 0 || strcmp(operand, "puts") == 0 || strcmp(operand, "putb") == 0 || strcmp(operand, "pbrkl") == 0) {
+            accumulatorValue = UNKNOWN_VALUE;
+        }
+
+        // Input routines return the read value in evval, leaving anything in the accumulator
+        else if (strcmp(operand, "scani") == 0 || strcmp(operand, "scans") == 0) {
+            accumulatorValue = UNKNOWN_VALUE;
+            setLocationValue("evval", newSymbolicValue());
+        }
+
+        // Any other sub-routine (functions, activation record management) may change everything
+        else invalidateRegisterCache();
+
+    }
+
+    else if (strcmp(mnemonic, "RS") == 0 || strcmp(mnemonic, "HM") == 0) invalidateRegisterCache();
+
+}
+
+// Returns 1 if a location is known to hold the same value as another one
+static int locationHoldsValueOf(const char* location, const char* source) {
+    int value = getLocationValue(location);
+    return value != UNKNOWN_VALUE && value == getLocationValue(source);
+}
+
+// Returns 1 if a location is known to hold a given constant
+static int locationHoldsConstant(const char* location, int constant) {
+    return getLocationValue(location) == constant;
+}
+
+
+// INSTRUCTIONS
+
+// Writes an instruction to the output. A labelled instruction may be reached by a jump, so the register cache is
+// invalidated; an unlabelled one is skipped if the register cache proves that it has no effect.
+static void generateInstruction(const char* label, const char* mnemonic, const char* operand, const char* comment) {
+
+    if (label != NULL) invalidateRegisterCache();
+    else if (isRedundantInstruction(mnemonic, operand)) return;
+
+    if (label != NULL) fprintf(outputCode, "%-8s", label);
+    else fprintf(outputCode, INSTRUCTION_PADDING);
+
+    if (comment != NULL) fprintf(outputCode, "%-4s%-8s; %s\n", mnemonic, operand, comment);
+    else fprintf(outputCode, "%-4s%s\n", mnemonic, operand);
+    generatedWords++;
+
+    updateRegisterCache(mnemonic, operand);
+
+}
+
+// Writes an instruction whose operand is a numeric value
+static void generateValueInstruction(const char* label, const char* mnemonic, int value, const char* comment) {
+    char operand[8];
+    sprintf(operand, "/%03x", value);
+    generateInstruction(label, mnemonic, operand, comment);
+}
+
+// Writes a data word: a patch cell or a slot of a static activation record
+static void generateDataWord(const char* label) {
+    fprintf(outputCode, "%-8sK   /0\n", label);
+    generatedWords++;
+}
+
 
 int initializeCodeGenerator(const char* outputFilename, const char* sourceCodeFilename) {
     
     // Try to open file.
-    outputCode = fopen(outputFilename, "w");
+    outputFile = fopen(outputFilename, "w");
+    outputCode = compilerOptions.optimizeSize && outputFile != NULL ? tmpfile() : outputFile;
     
     // If file could be opened, continue, otherwise return 0.
     if (outputCode != NULL) {
@@ -54,10 +301,15 @@ int initializeCodeGenerator(const char* outputFilename, const char* sourceCodeFi
         fprintf(outputCode, "evoffs  <\n");
         fprintf(outputCode, "evsign  <\n");
         fprintf(outputCode, "evtemp  <\n");
+        fprintf(outputCode, "evarg   <\n");
+        fprintf(outputCode, "evret   <\n");
         fprintf(outputCode, "ercad   <\n");
         fprintf(outputCode, "erwrt   <\n");
         fprintf(outputCode, "errd    <\n");
         fprintf(outputCode, "ercpb   <\n");
+        fprintf(outputCode, "erbnd   <\n");
+        fprintf(outputCode, "ekldcd  <\n");
+        fprintf(outputCode, "ekwrcd  <\n");
         fprintf(outputCode, "svbptr  <\n");
         fprintf(outputCode, "svsptr  <\n");
         fprintf(outputCode, "svsize  <\n");
@@ -81,82 +333,221 @@ int initializeCodeGenerator(const char* outputFilename, const char* sourceCodeFi
     
 }
 
-void generateOffsetFromBasePointer(int offset) {
-    fprintf(outputCode, "%sLD  svbptr\n", INSTRUCTION_PADDING);
-    fprintf(outputCode, "%sMM  evaddr\n", INSTRUCTION_PADDING);
-    fprintf(outputCode, "%sLV  /%03x\n", INSTRUCTION_PADDING, offset);
-    fprintf(outputCode, "%sMM  evoffs\n", INSTRUCTION_PADDING);
+static void generateStaticSlotLabel(int functionIndex, int offset, char label[7]) {
+    sprintf(label, "s%02x%03x", functionIndex, offset);
+}
+
+// Words of the string buffer, with its counter
+static int getStringBufferWords() {
+    if (stringBufferCounter == 0) return 1 + 0x100;
+    return 1 + stringBufferCounter / 2 + 256 - stringBufferCounter;
+}
+
+// Inline variable accessor: computes the address of the slot at offset from basePointer and patches the
+// command constant (ekldcd or ekwrcd) with it into a cell of its own, which is executed right after.
+// Reading: result in evval. Writing: value already in evval. Returns 0 if the code size budget is exhausted, or if
+// the accessor would take memory of the stack.
+static int generateInlineAccessor(const char* basePointer, int offset, int isWriting) {
+
+    char cell[7];
+    char slot[LOCATION_NAME_SIZE];
+    int value;
+
+    if (!compilerOptions.inlineAccessors || inlineAccessorsSize + INLINE_ACCESSOR_SIZE > compilerOptions.inlineAccessorsBudget) return 0;
+    if ((MEMORY_WORDS - ENVIRONMENT_WORDS - generatedWords - getStringBufferWords() - inlineAccessorsStackWords) * 2 < INLINE_ACCESSOR_SIZE) return 0;
+    inlineAccessorsSize += INLINE_ACCESSOR_SIZE;
+
+    sprintf(cell, "p%02x%03x", currentFunctionIndex, patchCellCounter++);
+    sprintf(slot, "[%x:%x]", getOrCreateLocationValue(basePointer), offset);
+
+    generateValueInstruction(NULL, "LV", offset * 2, NULL);
+    generateInstruction(NULL, "+", basePointer, NULL);
+    generateInstruction(NULL, "+", isWriting ? "ekwrcd" : "ekldcd", NULL);
+    generateInstruction(NULL, "MM", cell, NULL);
+    if (isWriting) generateInstruction(NULL, "LD", "evval", NULL);
+
+    // The cell is only reached by falling through, so the register cache stays valid
+    generateDataWord(cell);
+
+    if (isWriting) {
+        value = getOrCreateLocationValue("evval");
+        invalidateAliasedSlots(slot);
+        setLocationValue(slot, value);
+        accumulatorValue = value;
+    } else {
+        accumulatorValue = getOrCreateLocationValue(slot);
+        generateInstruction(NULL, "MM", "evval", NULL);
+    }
+
+    return 1;
+
+}
+
+static void generateOffsetFromBasePointer(int offset) {
+    if (!locationHoldsValueOf("evaddr", "svbptr")) {
+        generateInstruction(NULL, "LD", "svbptr", NULL);
+        generateInstruction(NULL, "MM", "evaddr", NULL);
+    }
+    if (!locationHoldsConstant("evoffs", offset)) {
+        generateValueInstruction(NULL, "LV", offset, NULL);
+        generateInstruction(NULL, "MM", "evoffs", NULL);
+    }
+}
+
+static int isVariableOperand(Operand operand) {
+    return operand.type == opdtVariable || operand.type == opdtTemporary;
+}
+
+// Returns 1 and the label of the operand if it can be used directly as an instruction operand
+static int getDirectOperandLocation(Operand operand, char location[LOCATION_NAME_SIZE]) {
+    if (isVariableOperand(operand) && staticFrameFunction >= 0) {
+        generateStaticSlotLabel(staticFrameFunction, operand.value, location);
+        return 1;
+    }
+    return 0;
 }
 
 // Result in evval
-void generateReadingVariable(int offset) {
+static void generateReadingVariable(int offset) {
+
+    char slot[LOCATION_NAME_SIZE];
+    int basePointer = getLocationValue("svbptr");
+
+    // Static activation record: load the slot directly
+    if (staticFrameFunction >= 0) {
+        generateStaticSlotLabel(staticFrameFunction, offset, slot);
+        generateInstruction(NULL, "LD", slot, NULL);
+        generateInstruction(NULL, "MM", "evval", NULL);
+        return;
+    }
+
+    // Skip the reading if evval already holds the variable
+    if (basePointer != UNKNOWN_VALUE) {
+        sprintf(slot, "[%x:%x]", basePointer, offset);
+        if (locationHoldsValueOf("evval", slot)) return;
+    }
+
+    if (generateInlineAccessor("svbptr", offset, 0)) return;
+
     generateOffsetFromBasePointer(offset);
-    fprintf(outputCode, "%sSC  errd\n", INSTRUCTION_PADDING);
+    generateInstruction(NULL, "SC", "errd", NULL);
+
 }
 
 // Value already in evval
-void generateWritingVariable(int offset) {
+static void generateWritingVariable(int offset) {
+
+    char slot[LOCATION_NAME_SIZE];
+
+    // Static activation record: store the slot directly
+    if (staticFrameFunction >= 0) {
+        generateStaticSlotLabel(staticFrameFunction, offset, slot);
+        generateInstruction(NULL, "LD", "evval", NULL);
+        generateInstruction(NULL, "MM", slot, NULL);
+        return;
+    }
+
+    if (generateInlineAccessor("svbptr", offset, 1)) return;
+
     generateOffsetFromBasePointer(offset);
-    fprintf(outputCode, "%sSC  erwrt\n", INSTRUCTION_PADDING);
+    generateInstruction(NULL, "SC", "erwrt", NULL);
+
+}
+
+// Result in evval
+static void generateReadingOperand(Operand operand) {
+    if (isVariableOperand(operand)) generateReadingVariable(operand.value);
+    else {
+        generateValueInstruction(NULL, "LV", operand.value, NULL);
+        generateInstruction(NULL, "MM", "evval", NULL);
+    }
+}
+
+// Result in the accumulator
+static void generateLoadingOperand(Operand operand) {
+
+    char location[LOCATION_NAME_SIZE];
+
+    if (getDirectOperandLocation(operand, location)) generateInstruction(NULL, "LD", location, NULL);
+    else if (isVariableOperand(operand)) {
+        generateReadingVariable(operand.value);
+        generateInstruction(NULL, "LD", "evval", NULL);
+    } else generateValueInstruction(NULL, "LV", operand.value, NULL);
+
+}
+
+// Value already in the accumulator
+static void generateStoringAccumulator(int offset) {
+
+    char slot[LOCATION_NAME_SIZE];
+
+    if (staticFrameFunction >= 0) {
+        generateStaticSlotLabel(staticFrameFunction, offset, slot);
+        generateInstruction(NULL, "MM", slot, NULL);
+    } else {
+        generateInstruction(NULL, "MM", "evval", NULL);
+        generateWritingVariable(offset);
+    }
+
 }
 
-void generateArithmeticOperation(Operator operation, Operand leftOperand, Operand rightOperand, int resultAddressOffset) {
+// Result in the accumulator
+static void generateArithmeticOperation(Operator operation, Operand leftOperand, Operand rightOperand, int resultAddressOffset) {
     
-    if (leftOperand.type == opdtVariable || leftOperand.type ==opdtTemporary) {
-        generateReadingVariable(leftOperand.value);
-        fprintf(outputCode, "%sLD  evval\n", INSTRUCTION_PADDING);
-    } else fprintf(outputCode, "%sLV  /%03x\n", INSTRUCTION_PADDING, leftOperand.value);
+    char leftLocation[LOCATION_NAME_SIZE];
+    char rightLocation[LOCATION_NAME_SIZE];
     
-    fprintf(outputCode, "%sMM  evtemp\n", INSTRUCTION_PADDING);
+    // Right operand directly accessible: operate on it from the left operand
+    if (getDirectOperandLocation(rightOperand, rightLocation)) generateLoadingOperand(leftOperand);
     
-    if (rightOperand.type == opdtVariable || rightOperand.type == opdtTemporary) generateReadingVariable(rightOperand.value);
+    // Otherwise the right operand goes to evval, keeping the left one in evtemp if it has to be read too
     else {
-        fprintf(outputCode, "%sLV  /%03x\n", INSTRUCTION_PADDING, rightOperand.value);
-        fprintf(outputCode, "%sMM  evval\n", INSTRUCTION_PADDING);
+        if (getDirectOperandLocation(leftOperand, leftLocation)) {
+            generateReadingOperand(rightOperand);
+            generateInstruction(NULL, "LD", leftLocation, NULL);
+        } else {
+            generateLoadingOperand(leftOperand);
+            generateInstruction(NULL, "MM", "evtemp", NULL);
+            generateReadingOperand(rightOperand);
+            generateInstruction(NULL, "LD", "evtemp", NULL);
+        }
+        strcpy(rightLocation, "evval");
     }
     
-    fprintf(outputCode, "%sLD  evtemp\n", INSTRUCTION_PADDING);
-    
     switch (operation) {
-        case oprAdd: fprintf(outputCode, "%s+   evval\n", INSTRUCTION_PADDING); break;
-        case oprSubtract: fprintf(outputCode, "%s-   evval\n", INSTRUCTION_PADDING); break;
-        case oprMultiply: fprintf(outputCode, "%s*   evval\n", INSTRUCTION_PADDING); break;
-        case oprDivide: fprintf(outputCode, "%s/   evval\n", INSTRUCTION_PADDING); break;
+        case oprAdd: generateInstruction(NULL, "+", rightLocation, NULL); break;
+        case oprSubtract: generateInstruction(NULL, "-", rightLocation, NULL); break;
+        case oprMultiply: generateInstruction(NULL, "*", rightLocation, NULL); break;
+        case oprDivide: generateInstruction(NULL, "/", rightLocation, NULL); break;
         default: break;
     }
     
-    fprintf(outputCode, "%sMM  evval\n", INSTRUCTION_PADDING);
-    
-    if (resultAddressOffset >= 0) generateWritingVariable(resultAddressOffset);
+    if (resultAddressOffset >= 0) generateStoringAccumulator(resultAddressOffset);
     
 }
 
-void generateInternalFunctionLabel(char label[7]) {
-    sprintf(label, "f%02x_%02x", functionLabelCounter, internalFunctionLabelCounter);
+static void generateInternalFunctionLabel(char label[7]) {
+    sprintf(label, "f%02x_%02x", currentFunctionIndex, internalFunctionLabelCounter);
     internalFunctionLabelCounter++;
 }
 
-void generateInternalFunctionLabelWithIndex(char label[7], int index) {
-    sprintf(label, "f%02x_%02x", functionLabelCounter, index);
+static void generateInternalFunctionLabelWithIndex(char label[7], int index) {
+    sprintf(label, "f%02x_%02x", currentFunctionIndex, index);
 }
 
-void generateFunctionLabel(int functionIndex, char label[7]) {
+static void generateFunctionLabel(int functionIndex, char label[7]) {
     
     if (functionIndex <= 255) sprintf(label, "f%02x", functionIndex);
     
 }
 
-void generateAttribution(Operand leftOperand, Operand rightOperand) {
-    if (rightOperand.type == opdtVariable || rightOperand.type == opdtTemporary) generateReadingVariable(rightOperand.value);
-    else {
-        fprintf(outputCode, "%sLV  /%03x\n", INSTRUCTION_PADDING, rightOperand.value);
-        fprintf(outputCode, "%sMM  evval\n", INSTRUCTION_PADDING);
-    }
-    generateWritingVariable(leftOperand.value);
+static void generateAttribution(Operand leftOperand, Operand rightOperand) {
+    generateLoadingOperand(rightOperand);
+    generateStoringAccumulator(leftOperand.value);
 }
 
 // Result in temp
-void generateRelationalComparison(Operator comparison, Operand leftOperand, Operand rightOperand, int resultAddressOffset) {
+static void generateRelationalComparison(Operator comparison, Operand leftOperand, Operand rightOperand, int resultAddressOffset) {
     
     char conditionLabel[7];
     char endLabel[7];
@@ -172,315 +563,659 @@ void generateRelationalComparison(Operator comparison, Operand leftOperand, Oper
     switch (comparison) {
             
         case oprSmallerOrEqualThan:
-            fprintf(outputCode, "%sJZ  %s\n", INSTRUCTION_PADDING, conditionLabel);
+            generateInstruction(NULL, "JZ", conditionLabel, NULL);
         case oprSmallerThan:
-            fprintf(outputCode, "%sJN  %s\n", INSTRUCTION_PADDING, conditionLabel);
+            generateInstruction(NULL, "JN", conditionLabel, NULL);
             trueIfJump = 1;
             break;
             
         case oprBiggerThan:
-            fprintf(outputCode, "%sJZ  %s\n", INSTRUCTION_PADDING, conditionLabel);
+            generateInstruction(NULL, "JZ", conditionLabel, NULL);
         case oprBiggerOrEqualThan:
-            fprintf(outputCode, "%sJN  %s\n", INSTRUCTION_PADDING, conditionLabel);
+            generateInstruction(NULL, "JN", conditionLabel, NULL);
             break;
             
         case oprEquals:
             trueIfJump = 1;
         case oprDifferent:
-            fprintf(outputCode, "%sJZ  %s\n", INSTRUCTION_PADDING, conditionLabel);
+            generateInstruction(NULL, "JZ", conditionLabel, NULL);
             break;
         
         default:break;
     }
     
-    if (trueIfJump) {
-        fprintf(outputCode, "%sLV  /000\n", INSTRUCTION_PADDING);
-        fprintf(outputCode, "%sJP  %s\n", INSTRUCTION_PADDING, endLabel);
-        fprintf(outputCode, "%s  LV  /001\n", conditionLabel);
-    } else {
-        fprintf(outputCode, "%sLV  /001\n", INSTRUCTION_PADDING);
-        fprintf(outputCode, "%sJP  %s\n", INSTRUCTION_PADDING, endLabel);
-        fprintf(outputCode, "%s  LV  /000\n", conditionLabel);
-    }
+    generateValueInstruction(NULL, "LV", trueIfJump ? 0 : 1, NULL);
+    generateInstruction(NULL, "JP", endLabel, NULL);
+    generateValueInstruction(conditionLabel, "LV", trueIfJump ? 1 : 0, NULL);
     
-    fprintf(outputCode, "%s  MM  evval\n", endLabel);
+    generateInstruction(endLabel, "MM", "evval", NULL);
     
     // Write result
     if (resultAddressOffset > 0) generateWritingVariable(resultAddressOffset);
     
 }
 
-void generateLogicalOperation(Operator operation, Operand leftOperand, Operand rightOperand, int resultAddressOffset) {
+static void generateLogicalOperation(Operator operation, Operand leftOperand, Operand rightOperand, int resultAddressOffset) {
     
     char leftConditionLabel[7];
     char rightConditionLabel[7];
     
-    if (leftOperand.type == opdtVariable || leftOperand.type == opdtTemporary) {
+    if (isVariableOperand(leftOperand)) {
         generateInternalFunctionLabel(leftConditionLabel);
-        generateReadingVariable(leftOperand.value);
-        fprintf(outputCode, "%sJZ  %s\n", INSTRUCTION_PADDING, leftConditionLabel);
-        fprintf(outputCode, "%sLV  /001\n", INSTRUCTION_PADDING);
-        fprintf(outputCode, "%s  MM  evtemp\n", leftConditionLabel);
+        generateLoadingOperand(leftOperand);
+        generateInstruction(NULL, "JZ", leftConditionLabel, NULL);
+        generateValueInstruction(NULL, "LV", 1, NULL);
+        generateInstruction(leftConditionLabel, "MM", "evtemp", NULL);
     } else {
-        fprintf(outputCode, "%sLV  /%03x\n", INSTRUCTION_PADDING, leftOperand.value != 0 ? 1 : 0);
-        fprintf(outputCode, "%s  MM  evtemp\n", INSTRUCTION_PADDING);
+        generateValueInstruction(NULL, "LV", leftOperand.value != 0 ? 1 : 0, NULL);
+        generateInstruction(NULL, "MM", "evtemp", NULL);
     }
     
-    if (rightOperand.type == opdtVariable || rightOperand.type == opdtTemporary) {
+    if (isVariableOperand(rightOperand)) {
         generateInternalFunctionLabel(rightConditionLabel);
-        generateReadingVariable(rightOperand.value);
-        fprintf(outputCode, "%sJZ  %s\n", INSTRUCTION_PADDING, rightConditionLabel);
-        fprintf(outputCode, "%sLV  /001\n", INSTRUCTION_PADDING);
-        fprintf(outputCode, "%s  MM  evval\n", rightConditionLabel);
+        generateLoadingOperand(rightOperand);
+        generateInstruction(NULL, "JZ", rightConditionLabel, NULL);
+        generateValueInstruction(NULL, "LV", 1, NULL);
+        generateInstruction(rightConditionLabel, "MM", "evval", NULL);
     } else {
-        fprintf(outputCode, "%sLV  /%03x\n", INSTRUCTION_PADDING, rightOperand.value != 0 ? 1 : 0);
-        fprintf(outputCode, "%s  MM  evval\n", INSTRUCTION_PADDING);
+        generateValueInstruction(NULL, "LV", rightOperand.value != 0 ? 1 : 0, NULL);
+        generateInstruction(NULL, "MM", "evval", NULL);
     }
     
-    fprintf(outputCode, "%sLD  evtemp\n", INSTRUCTION_PADDING);
+    generateInstruction(NULL, "LD", "evtemp", NULL);
     
-    if (operation == oprLogicAnd) fprintf(outputCode, "%s*   evval\n", INSTRUCTION_PADDING);
-    else if (operation == oprLogicOr) fprintf(outputCode, "%s+   evval\n", INSTRUCTION_PADDING);
+    if (operation == oprLogicAnd) generateInstruction(NULL, "*", "evval", NULL);
+    else if (operation == oprLogicOr) generateInstruction(NULL, "+", "evval", NULL);
 
-    fprintf(outputCode, "%sMM  evval\n", INSTRUCTION_PADDING);
+    generateInstruction(NULL, "MM", "evval", NULL);
     
     // Write result
     if (resultAddressOffset > 0) generateWritingVariable(resultAddressOffset);
     
 }
 
-int generateFunctionDeclaration(char* functionName, int activationRecordSize) {
+// Writes the activation record slots of a static activation record, from the given offset
+static void generateStaticActivationRecord(int functionIndex, int firstOffset, int activationRecordSize) {
+    char slot[7];
+    for (int offset = firstOffset; offset < activationRecordSize; offset++) {
+        generateStaticSlotLabel(functionIndex, offset, slot);
+        generateDataWord(slot);
+    }
+}
 
-    char functionLabel[LABEL_SIZE];
+static void generateFunctionDeclaration(IntermediateFunction* function) {
     
-    functionLabelCounter++;
-    internalFunctionLabelCounter = 0;
+    char functionLabel[7];
     
-    generateFunctionLabel(functionLabelCounter, functionLabel);
+    currentFunction = function;
+    currentFunctionIndex = function->index;
+    internalFunctionLabelCounter = function->labelCounter;
+    patchCellCounter = 0;
+    staticFrameFunction = function->hasStaticActivationRecord ? function->index : -1;
+
+    generateFunctionLabel(function->index, functionLabel);
     fprintf(outputCode, BREAK_LINE);
-    fprintf(outputCode, "; Function: %s  [Label: %s]\n", functionName, functionLabel);
-    fprintf(outputCode, "%s     K   /0\n", functionLabel);
+    fprintf(outputCode, "; Function: %s  [Label: %s]\n", function->name, functionLabel);
+
+    // Static activation record: the return address is kept by SC in the function label
+    if (function->hasStaticActivationRecord) {
+        generateInstruction(functionLabel, "K", "/0", "Static activation record");
+        return;
+    }
+
+    generateInstruction(functionLabel, "K", "/0", NULL);
     
     // Push new activation record
-    fprintf(outputCode, "%sLV  /%03x    ; Write function return address to activation record\n", INSTRUCTION_PADDING, activationRecordSize);
-    fprintf(outputCode, "%sMM  svsize\n", INSTRUCTION_PADDING);
-    fprintf(outputCode, "%sSC  srpsa\n", INSTRUCTION_PADDING);
-    
+    generateValueInstruction(NULL, "LV", function->activationRecordSize, "Write function return address to activation record");
+    generateInstruction(NULL, "MM", "svsize", NULL);
+    generateInstruction(NULL, "SC", "srpsa", NULL);
+    
+    // Light calling convention: the return address stays in the function label, the first argument is in evarg
+    if (function->usesLightCallingConvention) {
+        if (function->firstParameterSize == 1) {
+            generateInstruction(NULL, "LD", "evarg", "Function code starts below");
+            generateStoringAccumulator(2);
+        }
+        return;
+    }
+
     // Write return address to activation record
-    fprintf(outputCode, "%sLD  %s\n", INSTRUCTION_PADDING, functionLabel);
-    fprintf(outputCode, "%sMM  evval\n", INSTRUCTION_PADDING);
-    fprintf(outputCode, "%sSC  srwfra  ; Function code starts below \n", INSTRUCTION_PADDING);
-    
-    return functionLabelCounter;
+    generateInstruction(NULL, "LD", functionLabel, NULL);
+    generateInstruction(NULL, "MM", "evval", NULL);
+    generateInstruction(NULL, "SC", "srwfra", "Function code starts below");
     
 }
 
-void generateFunctionEnd(int functionAddress) {
+static void generateFunctionEnd(IntermediateFunction* function) {
     
-    char functionLabel[LABEL_SIZE];
+    char functionLabel[7];
     char returnLabel[7];
     
-    generateFunctionLabel(functionAddress, functionLabel);
-    generateInternalFunctionLabelWithIndex(returnLabel, 255);
+    // Returns of memoized functions go through the memoization of the returned value first
+    generateFunctionLabel(function->index, functionLabel);
+    generateInternalFunctionLabelWithIndex(returnLabel, function->memoizedArguments > 0 ? MEMOIZED_RETURN_LABEL : 255);
+
+    if (function->hasStaticActivationRecord) {
+        generateInstruction(returnLabel, "RS", functionLabel, NULL);
+        generateStaticActivationRecord(function->index, 2, function->activationRecordSize);
+        return;
+    }
+
+    if (function->usesLightCallingConvention) {
+        generateInstruction(returnLabel, "SC", "srppa", "Pop activation record");
+        generateInstruction(NULL, "RS", functionLabel, NULL);
+        return;
+    }
     
-    fprintf(outputCode, "%s  SC  srrfra  ; Retrieve return address and pop activation record\n", returnLabel);
-    fprintf(outputCode, "%sMM  %s\n", INSTRUCTION_PADDING, functionLabel);
-    fprintf(outputCode, "%sSC  srppa\n", INSTRUCTION_PADDING);
-    fprintf(outputCode, "%sRS  %s\n", INSTRUCTION_PADDING, functionLabel);
+    generateInstruction(returnLabel, "SC", "srrfra", "Retrieve return address and pop activation record");
+    generateInstruction(NULL, "MM", functionLabel, NULL);
+    generateInstruction(NULL, "SC", "srppa", NULL);
+    generateInstruction(NULL, "RS", functionLabel, NULL);
     
 }
 
-void generateNewTemporaryVariable() {
-    if (!temporaryVariableAlreadyCreated) {
-        fprintf(outputCode, "%sSC  srptv\n", INSTRUCTION_PADDING);
-    } else temporaryVariableAlreadyCreated = 0;
+// ARRAY ELEMENTS
+
+static void generateAddress(Operand variable, int position, int resultAddressOffset) {
+
+    char slot[7];
+
+    if (staticFrameFunction >= 0) {
+        generateStaticSlotLabel(staticFrameFunction, variable.value + position, slot);
+        generateInstruction(NULL, "LV", slot, NULL);
+    } else {
+        generateValueInstruction(NULL, "LV", (variable.value + position) * 2, NULL);
+        generateInstruction(NULL, "+", "svbptr", NULL);
+    }
+
+    generateStoringAccumulator(resultAddressOffset);
+
 }
 
-// IF
+// Element accessed through a command (ekldcd or ekwrcd) patched with its address into a cell of its own, like the
+// inline variable accessors. Writing: the value is loaded between the patch and the cell.
+static void generateElementAccess(Operand address, Operand* value) {
+
+    char cell[7];
+
+    sprintf(cell, "p%02x%03x", currentFunctionIndex, patchCellCounter++);
+
+    generateLoadingOperand(address);
+    generateInstruction(NULL, "+", value != NULL ? "ekwrcd" : "ekldcd", NULL);
+    generateInstruction(NULL, "MM", cell, NULL);
+    if (value != NULL) generateLoadingOperand(*value);
+
+    // The cell is only reached by falling through. Any slot may have been written by it.
+    generateDataWord(cell);
+    if (value != NULL) invalidateRegisterCache();
+    else accumulatorValue = newSymbolicValue();
 
-void generateIfCommand(Operand condition) {
-    
-    char ifLabell[7];
-    
-    if (condition.type == opdtVariable || condition.type == opdtTemporary) {
-        generateReadingVariable(condition.value);
-        fprintf(outputCode, "%sLD  evval\n", INSTRUCTION_PADDING);
-    } else fprintf(outputCode, "%sLV  /%03x\n", INSTRUCTION_PADDING, condition.value);
-    
-    generateInternalFunctionLabel(ifLabell);
-    pushIntegerToStack(&labelStack, internalFunctionLabelCounter - 1);
-    
-    fprintf(outputCode, "%sJZ  %s  ; If command\n", INSTRUCTION_PADDING, ifLabell);
-    
 }
 
-void generateElseCommand() {
-    
-    char elseLabel[7];
-    char endLabel[7];
-    
-    int elseLabelIndex;
-    popIntegerFromStack(&labelStack, &elseLabelIndex);
+static void generateLoad(Operand address, int resultAddressOffset) {
+    generateElementAccess(address, NULL);
+    generateStoringAccumulator(resultAddressOffset);
+}
 
-    generateInternalFunctionLabelWithIndex(elseLabel, elseLabelIndex);
-    generateInternalFunctionLabel(endLabel);
-    
-    pushIntegerToStack(&labelStack, internalFunctionLabelCounter - 1);
-    
-    fprintf(outputCode, "%sJP  %s\n", INSTRUCTION_PADDING, endLabel);
-    fprintf(outputCode, "%s  OS  /000    ; Else\n", elseLabel);
-    
+static void generateStore(Operand value, Operand address) {
+    generateElementAccess(address, &value);
 }
 
-void generateEndIf() {
-    
-    char endLabel[7];
-    int endLabelIndex;
-    popIntegerFromStack(&labelStack, &endLabelIndex);
-    
-    generateInternalFunctionLabelWithIndex(endLabel, endLabelIndex);
-    
-    fprintf(outputCode, "%s  OS  /000    ; Endif\n", endLabel);
-    
+// The program stops in erbnd if the index or size - 1 - index is negative
+static void generateBoundsCheck(Operand index, int size) {
+
+    Operand lastIndex = { opdtInteger, stInt, size - 1 };
+
+    // Constant index left unchecked by the optimizer, or missing dimension: decided at compile time
+    if (!isVariableOperand(index) || size <= 0) {
+        if (index.value < 0 || index.value >= size) generateInstruction(NULL, "JP", "erbnd", "Index out of bounds");
+        return;
+    }
+
+    generateLoadingOperand(index);
+    generateInstruction(NULL, "JN", "erbnd", "Index out of bounds");
+    generateArithmeticOperation(oprSubtract, lastIndex, index, -1);
+    generateInstruction(NULL, "JN", "erbnd", NULL);
+
 }
 
-// WHILE
+// LABELS AND JUMPS
 
-void generateWhileCommand() {
-    
-    char whileLabel[7];
-    
-    generateInternalFunctionLabel(whileLabel);
-    pushIntegerToStack(&labelStack, internalFunctionLabelCounter - 1);
-    
-    generateNewTemporaryVariable();
-    temporaryVariableAlreadyCreated = 1;
-    fprintf(outputCode, "%s  OS  /000    ; While\n", whileLabel);
-    
+static void generateLabel(int index, const char* comment) {
+    char label[7];
+    generateInternalFunctionLabelWithIndex(label, index);
+    generateValueInstruction(label, "OS", 0, comment);
 }
 
-void generateWhileTest(Operand condition) {
-    
-    char endLabel[7];
-    
-    generateInternalFunctionLabel(endLabel);
-    pushIntegerToStack(&labelStack, internalFunctionLabelCounter - 1);
-    
-    if (condition.type == opdtVariable || condition.type == opdtTemporary) {
-        generateReadingVariable(condition.value);
-        fprintf(outputCode, "%sLD  evval\n", INSTRUCTION_PADDING);
-    } else fprintf(outputCode, "%sLV  /%03x\n", INSTRUCTION_PADDING, condition.value);
-    
-    fprintf(outputCode, "%sJZ  %s    ; While Condition\n", INSTRUCTION_PADDING, endLabel);
+static void generateJump(int index, const char* comment) {
+    char label[7];
+    generateInternalFunctionLabelWithIndex(label, index);
+    generateInstruction(NULL, "JP", label, comment);
 }
 
-void generateEndWhile() {
-    
-    char whileLabel[7];
-    char endLabel[7];
-    
-    int whileLabelIndex;
-    int endLabelIndex;
-    
-    popIntegerFromStack(&labelStack, &endLabelIndex);
-    generateInternalFunctionLabelWithIndex(endLabel, endLabelIndex);
-    
-    popIntegerFromStack(&labelStack, &whileLabelIndex);
-    generateInternalFunctionLabelWithIndex(whileLabel, whileLabelIndex);
-    
-    fprintf(outputCode, "%sJP  %s\n", INSTRUCTION_PADDING, whileLabel);
-    fprintf(outputCode, "%s  OS  /000    ; Endwhile\n", endLabel);
-    
+static void generateJumpIfFalse(Operand condition, int index, const char* comment) {
+    char label[7];
+    generateInternalFunctionLabelWithIndex(label, index);
+    generateLoadingOperand(condition);
+    generateInstruction(NULL, "JZ", label, comment);
+}
+
+// Booleans are 0, 1 or 2 (logical or), so 0 minus a true value is negative
+static void generateJumpIfTrue(Operand condition, int index, const char* comment) {
+    char label[7];
+    Operand zero = { opdtInteger, stInt, 0 };
+    generateInternalFunctionLabelWithIndex(label, index);
+    generateArithmeticOperation(oprSubtract, zero, condition, -1);
+    generateInstruction(NULL, "JN", label, comment);
+}
+
+// Jumps if the comparison of the operands gives the expected result, testing the difference of the operands
+// with JN and JZ (bigger than compares the right operand minus the left one)
+static void generateComparisonJump(Operator comparison, Operand leftOperand, Operand rightOperand, int isJumpIfTrue, int index, const char* comment) {
+
+    char label[7];
+
+    // Comparison which must be true to jump
+    if (!isJumpIfTrue) {
+        switch (comparison) {
+            case oprSmallerThan: comparison = oprBiggerOrEqualThan; break;
+            case oprSmallerOrEqualThan: comparison = oprBiggerThan; break;
+            case oprBiggerThan: comparison = oprSmallerOrEqualThan; break;
+            case oprBiggerOrEqualThan: comparison = oprSmallerThan; break;
+            case oprEquals: comparison = oprDifferent; break;
+            case oprDifferent: comparison = oprEquals; break;
+            default: break;
+        }
+    }
+
+    generateInternalFunctionLabelWithIndex(label, index);
+
+    // Jumping if different would need two jumps: jump if the result of the equality is false instead
+    if (comparison == oprDifferent) {
+        generateRelationalComparison(oprEquals, leftOperand, rightOperand, -1);
+        generateInstruction(NULL, "JZ", label, comment);
+        return;
+    }
+
+    if (comparison == oprBiggerThan || comparison == oprBiggerOrEqualThan) generateArithmeticOperation(oprSubtract, rightOperand, leftOperand, -1);
+    else generateArithmeticOperation(oprSubtract, leftOperand, rightOperand, -1);
+
+    if (comparison == oprEquals) generateInstruction(NULL, "JZ", label, comment);
+    else generateInstruction(NULL, "JN", label, comment);
+    if (comparison == oprSmallerOrEqualThan || comparison == oprBiggerOrEqualThan) generateInstruction(NULL, "JZ", label, NULL);
+
 }
 
-void generateFunctionReturn(Operand* returnOperand) {
+// FUNCTION CALL
+    
+static void generateFunctionReturn(Operand* returnOperand) {
     
     char endLabel[7];
     
     generateInternalFunctionLabelWithIndex(endLabel, 255);
     
-    if (returnOperand != NULL) {
-        if ((*returnOperand).type == opdtVariable || (*returnOperand).type == opdtTemporary) {
-            generateReadingVariable((*returnOperand).value);
-            
-        } else {
-            fprintf(outputCode, "%sLV  /%03x\n", INSTRUCTION_PADDING, (*returnOperand).value);
-            fprintf(outputCode, "%sMM  evval\n", INSTRUCTION_PADDING);
-        }
-        
+    if (returnOperand != NULL && currentFunction->usesLightCallingConvention) {
+        generateLoadingOperand(*returnOperand);
+        generateInstruction(NULL, "MM", "evret", NULL);
+    } else if (returnOperand != NULL) {
+        generateReadingOperand(*returnOperand);
         generateWritingVariable(2); // TO DO: Arrays, structs
     }
     
-    fprintf(outputCode, "%sJP  %s  ; Return\n", INSTRUCTION_PADDING, endLabel);
+    generateInstruction(NULL, "JP", endLabel, "Return");
     
 }
 
-void generatePassingParameter(Operand parameter, int address, int size) {
+static void generatePassingParameter(Operand parameter, int functionAddress, int address, int size) {
     
-    if (size == 1) {
-        if (parameter.type == opdtVariable || parameter.type == opdtTemporary) {
-            generateReadingVariable(parameter.value);
+    char location[LOCATION_NAME_SIZE];
+    char slot[7];
+    IntermediateFunction* function = getIntermediateFunction(functionAddress);
+
+    // Static activation record of the called function: write the parameter into its slot
+    if (function->hasStaticActivationRecord) {
+        generateStaticSlotLabel(functionAddress, address, slot);
+        if (size == 1) {
+            generateLoadingOperand(parameter);
+            generateInstruction(NULL, "MM", slot, NULL);
         } else {
-            fprintf(outputCode, "%sLV  /%03x\n", INSTRUCTION_PADDING, parameter.value);
-            fprintf(outputCode, "%sMM  evval\n", INSTRUCTION_PADDING);
+            if (getDirectOperandLocation(parameter, location)) generateInstruction(NULL, "LV", location, NULL);
+            else generateValueInstruction(NULL, "LV", parameter.value, NULL);
+            generateInstruction(NULL, "MM", "evaddr", NULL);
+            generateInstruction(NULL, "LV", slot, NULL);
+            generateInstruction(NULL, "MM", "evval", NULL);
+            generateValueInstruction(NULL, "LV", size, NULL);
+            generateInstruction(NULL, "MM", "evoffs", NULL);
+            generateInstruction(NULL, "SC", "ercpb", NULL);
+        }
+        return;
+    }
+
+    // Light calling convention: first scalar argument in evarg
+    if (function->usesLightCallingConvention && address == 2 && size == 1) {
+        generateLoadingOperand(parameter);
+        generateInstruction(NULL, "MM", "evarg", NULL);
+        return;
+    }
+
+    if (size == 1) {
+        generateReadingOperand(parameter);
+        if (generateInlineAccessor("svsptr", address + 1, 1)) return;
+        if (!locationHoldsValueOf("evaddr", "svsptr")) {
+            generateInstruction(NULL, "LD", "svsptr", NULL);
+            generateInstruction(NULL, "MM", "evaddr", NULL);
         }
-        fprintf(outputCode, "%sLD  svsptr\n", INSTRUCTION_PADDING);
-        fprintf(outputCode, "%sMM  evaddr\n", INSTRUCTION_PADDING);
-        fprintf(outputCode, "%sLV  /%03x\n", INSTRUCTION_PADDING, address + 1);
-        fprintf(outputCode, "%sMM  evoffs\n", INSTRUCTION_PADDING);
-        fprintf(outputCode, "%sSC  erwrt\n", INSTRUCTION_PADDING);
+        if (!locationHoldsConstant("evoffs", address + 1)) {
+            generateValueInstruction(NULL, "LV", address + 1, NULL);
+            generateInstruction(NULL, "MM", "evoffs", NULL);
+        }
+        generateInstruction(NULL, "SC", "erwrt", NULL);
     } else {
-        fprintf(outputCode, "%sLV  /%03x\n", INSTRUCTION_PADDING, parameter.value);
-        fprintf(outputCode, "%sMM  evaddr\n", INSTRUCTION_PADDING);
-        fprintf(outputCode, "%sLV  /%03x\n", INSTRUCTION_PADDING, address + 1);
-        fprintf(outputCode, "%s+   svsptr\n", INSTRUCTION_PADDING);
-        fprintf(outputCode, "%sMM  evval\n", INSTRUCTION_PADDING);
-        fprintf(outputCode, "%sLV  /%03x\n", INSTRUCTION_PADDING, size);
-        fprintf(outputCode, "%sMM  evoffs\n", INSTRUCTION_PADDING);
-        fprintf(outputCode, "%sSC  ercpb\n", INSTRUCTION_PADDING);
+        if (getDirectOperandLocation(parameter, location)) generateInstruction(NULL, "LV", location, NULL);
+        else generateValueInstruction(NULL, "LV", parameter.value, NULL);
+        generateInstruction(NULL, "MM", "evaddr", NULL);
+        generateValueInstruction(NULL, "LV", address + 1, NULL);
+        generateInstruction(NULL, "+", "svsptr", NULL);
+        generateInstruction(NULL, "MM", "evval", NULL);
+        generateValueInstruction(NULL, "LV", size, NULL);
+        generateInstruction(NULL, "MM", "evoffs", NULL);
+        generateInstruction(NULL, "SC", "ercpb", NULL);
     }
     
 }
 
-void generateFunctionCall(int functionAddress, int resultAddressOffset, int returnValueSize) {
-    
+// Light calling convention: restores the return address of the current function, saved in its activation record
+static void generateRestoringReturnAddress() {
     char functionLabel[7];
+    Operand returnAddress = { opdtVariable, -1, 1 };
+    generateFunctionLabel(currentFunctionIndex, functionLabel);
+    generateLoadingOperand(returnAddress);
+    generateInstruction(NULL, "MM", functionLabel, NULL);
+}
+
+static void generateFunctionCall(int functionAddress, int resultAddressOffset, int returnValueSize) {
     
+    char functionLabel[7];
+    char callerLabel[7];
+    char location[LOCATION_NAME_SIZE];
+    char slot[7];
+    Operand result = { opdtTemporary, -1, resultAddressOffset };
+    IntermediateFunction* function = getIntermediateFunction(functionAddress);
+    
+    // Light calling convention: if the called function may call the current one again, the return address kept in
+    // the label of the current function would be overwritten, so it is saved in the activation record meanwhile
+    int preservesReturnAddress = currentFunction->usesLightCallingConvention && canReachFunction(functionAddress, currentFunctionIndex);
+
     generateFunctionLabel(functionAddress, functionLabel);
+    generateFunctionLabel(currentFunctionIndex, callerLabel);
+
+    if (preservesReturnAddress) {
+        generateInstruction(NULL, "LD", callerLabel, NULL);
+        generateStoringAccumulator(1);
+    }
     
-    fprintf(outputCode, "%sSC  %s      ; Call function\n", INSTRUCTION_PADDING, functionLabel);
+    generateInstruction(NULL, "SC", functionLabel, "Call function");
+
+    // Light calling convention of the called function: the returned value is in evret
+    if (function->usesLightCallingConvention) {
+        if (returnValueSize == 1) {
+            generateInstruction(NULL, "LD", "evret", NULL);
+            generateStoringAccumulator(resultAddressOffset);
+        }
+        if (preservesReturnAddress) generateRestoringReturnAddress();
+        return;
+    }
+
+    if (preservesReturnAddress) generateRestoringReturnAddress();
+
+    // Static activation record of the called function: the returned value is in its slot
+    if (function->hasStaticActivationRecord && returnValueSize > 0) {
+        generateStaticSlotLabel(functionAddress, 2, slot);
+        if (returnValueSize == 1) {
+            generateInstruction(NULL, "LD", slot, NULL);
+            generateStoringAccumulator(resultAddressOffset);
+        } else {
+            generateInstruction(NULL, "LV", slot, NULL);
+            generateInstruction(NULL, "MM", "evaddr", NULL);
+            if (getDirectOperandLocation(result, location)) generateInstruction(NULL, "LV", location, NULL);
+            else generateValueInstruction(NULL, "LV", resultAddressOffset, NULL);
+            generateInstruction(NULL, "MM", "evval", NULL);
+            generateValueInstruction(NULL, "LV", returnValueSize, NULL);
+            generateInstruction(NULL, "MM", "evoffs", NULL);
+            generateInstruction(NULL, "SC", "ercpb", NULL);
+        }
+        return;
+    }
     
     if (returnValueSize == 1) {
-        fprintf(outputCode, "%sLD  svsptr\n", INSTRUCTION_PADDING);
-        fprintf(outputCode, "%sMM  evaddr\n", INSTRUCTION_PADDING);
-        fprintf(outputCode, "%sLV  /%03x\n", INSTRUCTION_PADDING, 3);
-        fprintf(outputCode, "%sMM  evoffs\n", INSTRUCTION_PADDING);
-        fprintf(outputCode, "%sSC  errd\n", INSTRUCTION_PADDING);
+        if (!generateInlineAccessor("svsptr", 3, 0)) {
+            generateInstruction(NULL, "LD", "svsptr", NULL);
+            generateInstruction(NULL, "MM", "evaddr", NULL);
+            generateValueInstruction(NULL, "LV", 3, NULL);
+            generateInstruction(NULL, "MM", "evoffs", NULL);
+            generateInstruction(NULL, "SC", "errd", NULL);
+        }
         generateWritingVariable(resultAddressOffset);
     } else {
-        fprintf(outputCode, "%sLV  /%03x\n", INSTRUCTION_PADDING, 3);
-        fprintf(outputCode, "%s+   svsptr\n", INSTRUCTION_PADDING);
-        fprintf(outputCode, "%sMM  evaddr\n", INSTRUCTION_PADDING);
-        fprintf(outputCode, "%sLV  /%03x\n", INSTRUCTION_PADDING, resultAddressOffset);
-        fprintf(outputCode, "%sMM  evval\n", INSTRUCTION_PADDING);
-        fprintf(outputCode, "%sLV  /%03x\n", INSTRUCTION_PADDING, returnValueSize);
-        fprintf(outputCode, "%sMM  evoffs\n", INSTRUCTION_PADDING);
-        fprintf(outputCode, "%sSC  ercpb\n", INSTRUCTION_PADDING);
+        generateValueInstruction(NULL, "LV", 3, NULL);
+        generateInstruction(NULL, "+", "svsptr", NULL);
+        generateInstruction(NULL, "MM", "evaddr", NULL);
+        if (getDirectOperandLocation(result, location)) generateInstruction(NULL, "LV", location, NULL);
+        else generateValueInstruction(NULL, "LV", resultAddressOffset, NULL);
+        generateInstruction(NULL, "MM", "evval", NULL);
+        generateValueInstruction(NULL, "LV", returnValueSize, NULL);
+        generateInstruction(NULL, "MM", "evoffs", NULL);
+        generateInstruction(NULL, "SC", "ercpb", NULL);
     }
     
 }
 
-void generateMain() {
+// MEMOIZATION
+
+static void generateMemoizationTableLabel(int functionIndex, char table, char label[7]) {
+    sprintf(label, "m%02x%c", functionIndex, table);
+}
+
+// Table entry accessed through a command (ekldcd or ekwrcd) patched with its address into a cell of its own, the
+// offset of the entry being in evtemp. Writing: the value is loaded between the patch and the cell, the returned
+// value if value is NULL.
+static void generateMemoizationTableAccess(char table, int isWriting, Operand* value) {
+
+    char tableLabel[7];
+    char cell[7];
+    Operand returnedValue = { opdtVariable, stInt, 2 };
+
+    generateMemoizationTableLabel(currentFunctionIndex, table, tableLabel);
+    sprintf(cell, "p%02x%03x", currentFunctionIndex, patchCellCounter++);
+
+    generateInstruction(NULL, "LV", tableLabel, NULL);
+    generateInstruction(NULL, "+", "evtemp", NULL);
+    generateInstruction(NULL, "+", isWriting ? "ekwrcd" : "ekldcd", NULL);
+    generateInstruction(NULL, "MM", cell, NULL);
+    if (isWriting && value != NULL) generateLoadingOperand(*value);
+    else if (isWriting && currentFunction->usesLightCallingConvention) generateInstruction(NULL, "LD", "evret", NULL);
+    else if (isWriting) generateLoadingOperand(returnedValue);
+
+    generateDataWord(cell);
+    if (isWriting) invalidateRegisterCache();
+    else accumulatorValue = newSymbolicValue();
+
+}
+
+// In front of the body: returns the memoized value of the argument if it is already computed
+static void generateMemoizationLookup(IntermediateFunction* function) {
+
+    Operand argument = { opdtVariable, stInt, 2 };
+    char argumentLocation[LOCATION_NAME_SIZE];
+    char lastArgumentLabel[7];
+    char missLabel[7];
+    char bodyLabel[7];
+    char returnLabel[7];
+
+    generateInternalFunctionLabelWithIndex(missLabel, MEMOIZATION_MISS_LABEL);
+    generateInternalFunctionLabelWithIndex(bodyLabel, MEMOIZATION_BODY_LABEL);
+    generateInternalFunctionLabelWithIndex(returnLabel, MEMOIZED_RETURN_LABEL);
+    generateMemoizationTableLabel(function->index, 'l', lastArgumentLabel);
+
+    // Arguments out of the tables: the negative value left in the accumulator is kept as their entry offset. The last
+    // argument kept is read from the word before the tables, whose size is chosen once the whole program is generated.
+    generateLoadingOperand(argument);
+    generateInstruction(NULL, "JN", missLabel, "Memoization");
+    if (!getDirectOperandLocation(argument, argumentLocation)) {
+        generateReadingOperand(argument);
+        strcpy(argumentLocation, "evval");
+    }
+    generateInstruction(NULL, "LD", lastArgumentLabel, NULL);
+    generateInstruction(NULL, "-", argumentLocation, NULL);
+    generateInstruction(NULL, "JN", missLabel, NULL);
+
+    // Offset of the entry of the argument (two bytes per word)
+    generateArithmeticOperation(oprAdd, argument, argument, -1);
+    generateInstruction(NULL, "MM", "evtemp", NULL);
+    generateStoringAccumulator(function->memoizationSlot);
+    generateInstruction(NULL, "LD", "evtemp", NULL);
+
+    generateMemoizationTableAccess('f', 0, NULL);
+    generateInstruction(NULL, "JZ", bodyLabel, NULL);
+    generateMemoizationTableAccess('v', 0, NULL);
+    if (function->usesLightCallingConvention) generateInstruction(NULL, "MM", "evret", NULL);
+    else generateStoringAccumulator(2);
+    generateInstruction(NULL, "JP", returnLabel, "Memoized value");
+
+    generateValueInstruction(missLabel, "OS", 0, NULL);
+    generateStoringAccumulator(function->memoizationSlot);
+    generateValueInstruction(bodyLabel, "OS", 0, "Function body");
+
+}
+
+// At the end of the function: memoizes the returned value, unless the argument is out of the tables
+static void generateMemoizationStore(IntermediateFunction* function) {
+
+    Operand entryOffset = { opdtTemporary, stInt, function->memoizationSlot };
+    Operand computed = { opdtInteger, stInt, 1 };
+    char returnLabel[7];
+
+    generateInternalFunctionLabelWithIndex(returnLabel, MEMOIZED_RETURN_LABEL);
+
+    generateLabel(255, "Memoize returned value");
+    generateLoadingOperand(entryOffset);
+    generateInstruction(NULL, "JN", returnLabel, NULL);
+    generateInstruction(NULL, "MM", "evtemp", NULL);
+    generateMemoizationTableAccess('f', 1, &computed);
+    generateMemoizationTableAccess('v', 1, NULL);
+
+}
+
+// Tables of flags and values, one word per argument, after the last argument they keep. The flags are written as
+// zeros, so nothing depends on the memory the loader leaves. The tables are reduced to fit in the memory left, a
+// function left without tables computing all its values (its lookup always misses). Returns the words written.
+static int generateMemoizationTables(IntermediateFunction* functions, int memoryLeft) {
+
+    int memoizedFunctionCount = 0;
+    int tableWords = 0;
+    int maxArguments = 0;
+    int writtenWords = 0;
+    int tableSize;
+    char label[7];
+
+    for (IntermediateFunction* function = functions; function != NULL; function = function->nextFunction) {
+        if (function->memoizedArguments == 0) continue;
+        memoizedFunctionCount++;
+        tableWords += 1 + 2 * function->memoizedArguments;
+    }
+    if (memoizedFunctionCount == 0) return 0;
+
+    // Same number of arguments for every function once they do not fit
+    if (tableWords > memoryLeft && memoryLeft > memoizedFunctionCount) maxArguments = (memoryLeft - memoizedFunctionCount) / (2 * memoizedFunctionCount);
+
+    fprintf(outputCode, BREAK_LINE);
+    fprintf(outputCode, ";  MEMOIZATION TABLES \n");
+
+    for (IntermediateFunction* function = functions; function != NULL; function = function->nextFunction) {
+
+        if (function->memoizedArguments == 0) continue;
+
+        if (tableWords > memoryLeft && function->memoizedArguments > maxArguments) {
+            function->memoizedArguments = maxArguments;
+            if (maxArguments > 0) fprintf(stderr, "Warning: the memoization tables of %s only keep %d arguments, to fit in the memory left\n", function->name, maxArguments);
+            else fprintf(stderr, "Warning: no memory left for the memoization tables of %s, which is not memoized\n", function->name);
+        }
+
+        // The code of the function, generated before its tables were reduced, refers to their labels: tables without
+        // arguments still take a word each for them, which is never accessed since the last argument kept is -1
+        tableSize = function->memoizedArguments > 0 ? function->memoizedArguments : 1;
+        generateMemoizationTableLabel(function->index, 'l', label);
+        fprintf(outputCode, "%-8sK   /%04x\n", label, (function->memoizedArguments - 1) & 0xffff);
+        generateMemoizationTableLabel(function->index, 'f', label);
+        for (int i = 0; i < tableSize; i++) fprintf(outputCode, "%-8sK   /0\n", i == 0 ? label : "");
+        generateMemoizationTableLabel(function->index, 'v', label);
+        fprintf(outputCode, "%-8s$   /%04x\n", label, tableSize);
+        writtenWords += 1 + 2 * tableSize;
+
+    }
+
+    return writtenWords;
+
+}
+
+
+// MAIN
+
+// Main's activation record always starts at the beginning of the stack, so it is static
+static void generateMain(IntermediateFunction* main) {
+
+    currentFunction = main;
+    currentFunctionIndex = main->index;
+    internalFunctionLabelCounter = main->labelCounter;
+    patchCellCounter = 0;
+    staticFrameFunction = main->index;
+
     fprintf(outputCode, BREAK_LINE);
     fprintf(outputCode, ";  MAIN \n");
-    fprintf(outputCode, "main    LV  stacks\n");
-    fprintf(outputCode, "%sMM  svbptr\n", INSTRUCTION_PADDING);
-    fprintf(outputCode, "%sLV  stacke\n", INSTRUCTION_PADDING);
-    fprintf(outputCode, "%sMM  svsptr\n", INSTRUCTION_PADDING);
+    generateInstruction("main", "LV", "stacks", NULL);
+    generateInstruction(NULL, "MM", "svbptr", NULL);
+    generateInstruction(NULL, "LV", "stackt", NULL);
+    generateInstruction(NULL, "MM", "svsptr", NULL);
+
+}
+
+// Words of the memory left which the memoization tables may take: all but the stack of the deepest call chain, or half
+// of them if the functions recurse without a bound, as their stack takes the rest
+static int getMemoizationMemory(IntermediateFunction* main, int memoryLeft) {
+    int stackDepth = getMaxStackDepth(main->index, compilerOptions.recursionDepth);
+    if (stackDepth == UNBOUNDED_STACK_DEPTH) return (memoryLeft - getMaxStackDepth(main->index, 1)) / 2;
+    return memoryLeft - stackDepth;
 }
 
-void generateMainEnd(int mainSize) {
-    fprintf(outputCode, "%sHM  main\n", INSTRUCTION_PADDING);
+// Reserves the dynamic activation records of the deepest call chain after the activation record of main, before the
+// end of the stack. If some function may recurse without a given bound, the records take the memory left after the
+// program instead.
+static void generateDynamicStack(IntermediateFunction* main, int memoryLeft) {
+
+    int stackDepth = getMaxStackDepth(main->index, compilerOptions.recursionDepth);
+
+    // The memory left must at least hold a call of each recursive function
+    if (stackDepth == UNBOUNDED_STACK_DEPTH) {
+        for (IntermediateFunction* function = getIntermediateFunctions(); function != NULL; function = function->nextFunction) {
+            if (isRecursiveFunction(function->index) && canReachFunction(main->index, function->index)) {
+                fprintf(stderr, "Note: recursive function %s has an unbounded stack depth, its calls may overflow the %d words left (see --recursion-depth)\n", function->name, memoryLeft);
+            }
+        }
+        stackDepth = getMaxStackDepth(main->index, 1);
+        if (stackDepth > memoryLeft) fprintf(stderr, "Warning: the memory left after the program (%d words) cannot hold the stack of a single call of each recursive function (%d words)\n", memoryLeft, stackDepth);
+        return;
+    }
+
+    if (stackDepth > memoryLeft) fprintf(stderr, "Warning: the stack (%d words) does not fit in the memory left after the program (%d words)\n", stackDepth, memoryLeft);
+    if (stackDepth > 0) fprintf(outputCode, "%s$   /%04x\n", INSTRUCTION_PADDING, stackDepth);
+
+}
+
+static void generateMainEnd(IntermediateFunction* main) {
+
+    int memoryLeft;
+
+    generateInstruction(NULL, "HM", "main", NULL);
     fprintf(outputCode, BREAK_LINE);
     fprintf(outputCode, ";  STRING BUFFER \n");
     fprintf(outputCode, "strbct  K  /%04x\n", stringBufferCounter);
@@ -490,84 +1225,89 @@ void generateMainEnd(int mainSize) {
         for (int i = 0; i < stringBufferCounter / 2; i++) fprintf(outputCode, "%s", stringBuffer[i]);
         fprintf(outputCode, "%s$  /%04x\n", INSTRUCTION_PADDING, 256 - stringBufferCounter);
     }
+
+    // Memory left after the environment, the code and data of the functions, the string buffer and the activation
+    // record of main (stacks and the word after it, its slots, stackt and stacke)
+    memoryLeft = MEMORY_WORDS - ENVIRONMENT_WORDS - generatedWords - getStringBufferWords() - (main->activationRecordSize > 2 ? main->activationRecordSize : 2) - 2;
+    memoryLeft -= generateMemoizationTables(getIntermediateFunctions(), getMemoizationMemory(main, memoryLeft));
+
+    // The code generated after the inline accessors may still leave too little memory for the stack
+    if (inlineAccessorsSize > 0 && getMaxStackDepth(main->index, 1) > memoryLeft) fprintf(stderr, "Warning: the inline accessors (%d bytes) leave less than a frame of each recursive function for the stack (see --inline-accessors)\n", inlineAccessorsSize);
+
     fprintf(outputCode, BREAK_LINE);
     fprintf(outputCode, ";  STACK \n");
     fprintf(outputCode, "stacks  K   /0\n");
-    while (mainSize) {
-        fprintf(outputCode, "%sK   /0\n", INSTRUCTION_PADDING);
-        mainSize--;
-    }
+    fprintf(outputCode, "%sK   /0\n", INSTRUCTION_PADDING);
+    generateStaticActivationRecord(main->index, 2, main->activationRecordSize);
+    fprintf(outputCode, "stackt  K   /0\n");
+    generateDynamicStack(main, memoryLeft);
     fprintf(outputCode, "stacke  K   /0\n");
     fprintf(outputCode, BREAK_LINE);
     fprintf(outputCode, "%s#   main\n", INSTRUCTION_PADDING);
+
 }
 
-void generateStringScan(int resultAddressOffset) {
-    fprintf(outputCode, "%sSC  scans\n", INSTRUCTION_PADDING);
+// SCAN
+
+static void generateStringScan(int resultAddressOffset) {
+    generateInstruction(NULL, "SC", "scans", NULL);
     generateWritingVariable(resultAddressOffset);
 }
 
-void generateIntScan(int resultAddressOffset) {
+static void generateIntScan(int resultAddressOffset) {
     
-    fprintf(outputCode, "%sSC  scani\n", INSTRUCTION_PADDING);
+    generateInstruction(NULL, "SC", "scani", NULL);
     generateWritingVariable(resultAddressOffset);
     
 }
 
-void generateBooleanScan(int resultAddressOffset) {
+static void generateBooleanScan(int resultAddressOffset) {
     
     char scanLabel[7];
   
     generateInternalFunctionLabel(scanLabel);
 
-    fprintf(outputCode, "%sSC  scani\n", INSTRUCTION_PADDING);
-    fprintf(outputCode, "%sLD  evval\n", INSTRUCTION_PADDING);
-    fprintf(outputCode, "%sJZ  %s\n", INSTRUCTION_PADDING, scanLabel);
-    fprintf(outputCode, "%sLV  /001\n", INSTRUCTION_PADDING);
-    fprintf(outputCode, "%s  MM  evval\n", scanLabel);
+    generateInstruction(NULL, "SC", "scani", NULL);
+    generateInstruction(NULL, "LD", "evval", NULL);
+    generateInstruction(NULL, "JZ", scanLabel, NULL);
+    generateValueInstruction(NULL, "LV", 1, NULL);
+    generateInstruction(scanLabel, "MM", "evval", NULL);
     generateWritingVariable(resultAddressOffset);
 }
 
-void generateStringPrint(Operand string) {
-    if (string.type == opdtVariable || string.type == opdtTemporary) {
+// PRINT
+
+static void generateBreakLinePrint() {
+    generateInstruction(NULL, "SC", "pbrkl", NULL);
+}
+
+static void generateStringPrint(Operand string) {
+    if (isVariableOperand(string)) {
         generateReadingVariable(string.value);
-        fprintf(outputCode, "%sSC  puts\n", INSTRUCTION_PADDING);
+        generateInstruction(NULL, "SC", "puts", NULL);
     } else {
         if (string.value >= 0) {
-            fprintf(outputCode, "%sLV  /%03x\n", INSTRUCTION_PADDING, string.value);
-            fprintf(outputCode, "%sMM  evval\n", INSTRUCTION_PADDING);
-            fprintf(outputCode, "%sSC  puts\n", INSTRUCTION_PADDING);
+            generateValueInstruction(NULL, "LV", string.value, NULL);
+            generateInstruction(NULL, "MM", "evval", NULL);
+            generateInstruction(NULL, "SC", "puts", NULL);
         } else generateBreakLinePrint();
     }
 }
 
-void generateBreakLinePrint() {
-    fprintf(outputCode, "%sSC  pbrkl\n", INSTRUCTION_PADDING);
+static void generateIntPrint(Operand integer) {
+    generateReadingOperand(integer);
+    generateInstruction(NULL, "SC", "puti", NULL);
 }
 
-void generateIntPrint(Operand integer) {
-    if (integer.type == opdtVariable || integer.type == opdtTemporary) {
-        generateReadingVariable(integer.value);
-    } else {
-        fprintf(outputCode, "%sLV  /%03x\n", INSTRUCTION_PADDING, integer.value);
-        fprintf(outputCode, "%sMM  evval\n", INSTRUCTION_PADDING);
-    }
-    fprintf(outputCode, "%sSC  puti\n", INSTRUCTION_PADDING);
-}
-
-void generateBooleanPrint(Operand boolean) {
-    if (boolean.type == opdtVariable || boolean.type == opdtTemporary) {
-        generateReadingVariable(boolean.value);
-    } else {
-        fprintf(outputCode, "%sLV  /%03x\n", INSTRUCTION_PADDING, boolean.value);
-        fprintf(outputCode, "%sMM  evval\n", INSTRUCTION_PADDING);
-    }
-    fprintf(outputCode, "%sSC  putb\n", INSTRUCTION_PADDING);
+static void generateBooleanPrint(Operand boolean) {
+    generateReadingOperand(boolean);
+    generateInstruction(NULL, "SC", "putb", NULL);
 }
 
 // Returns the string address in the buffer
 int generateStringLiteral(char* string) {
     int stringAddress = stringBufferCounter;
+
     for (int i = 1; i < strlen(string) - 1; i += 2) {
         char first = string[i];
         char second = string[i + 1];
@@ -583,3 +1323,93 @@ int generateStringLiteral(char* string) {
     return stringAddress;
 }
 
+// PROGRAM
+
+static void generateIntermediateInstruction(IntermediateInstruction* instruction) {
+
+    switch (instruction->operation) {
+
+        case icAttribution: generateAttribution(instruction->result, instruction->left); break;
+        case icArithmetic: generateArithmeticOperation(instruction->operator, instruction->left, instruction->right, instruction->result.value); break;
+        case icRelational: generateRelationalComparison(instruction->operator, instruction->left, instruction->right, instruction->result.value); break;
+        case icLogical: generateLogicalOperation(instruction->operator, instruction->left, instruction->right, instruction->result.value); break;
+
+        case icAddress: generateAddress(instruction->left, instruction->address, instruction->result.value); break;
+        case icLoad: generateLoad(instruction->left, instruction->result.value); break;
+        case icStore: generateStore(instruction->left, instruction->right); break;
+        case icBoundsCheck: generateBoundsCheck(instruction->left, instruction->size); break;
+
+        case icLabel: generateLabel(instruction->label, instruction->comment); break;
+        case icJump: generateJump(instruction->label, instruction->comment); break;
+        case icJumpIfFalse:
+        case icJumpIfTrue:
+            if (isComparisonJump(instruction)) generateComparisonJump(instruction->operator, instruction->left, instruction->right, instruction->operation == icJumpIfTrue, instruction->label, instruction->comment);
+            else if (instruction->operation == icJumpIfTrue) generateJumpIfTrue(instruction->left, instruction->label, instruction->comment);
+            else generateJumpIfFalse(instruction->left, instruction->label, instruction->comment);
+            break;
+
+        case icReturn: generateFunctionReturn(instruction->size > 0 ? &instruction->left : NULL); break;
+        case icParameter: generatePassingParameter(instruction->left, instruction->function, instruction->address, instruction->size); break;
+        case icFunctionCall: generateFunctionCall(instruction->function, instruction->result.value, instruction->size); break;
+
+        case icScan:
+            if (instruction->dataType == stString) generateStringScan(instruction->result.value);
+            else if (instruction->dataType == stInt) generateIntScan(instruction->result.value);
+            else if (instruction->dataType == stBoolean) generateBooleanScan(instruction->result.value);
+            break;
+
+        case icPrint:
+            if (instruction->dataType == stString) generateStringPrint(instruction->left);
+            else if (instruction->dataType == stInt) generateIntPrint(instruction->left);
+            else if (instruction->dataType == stBoolean) generateBooleanPrint(instruction->left);
+            break;
+
+    }
+
+}
+
+void generateProgram(IntermediateFunction* functions) {
+
+    int mergedFunctionCount = 0;
+    int savedBytes = 0;
+
+    // The inline accessors leave the stack of the deepest call chain, or a call of each recursive function if the
+    // recursion is unbounded
+    for (IntermediateFunction* function = functions; function != NULL; function = function->nextFunction) {
+        if (!function->isMain) continue;
+        inlineAccessorsStackWords = getMaxStackDepth(function->index, compilerOptions.recursionDepth);
+        if (inlineAccessorsStackWords == UNBOUNDED_STACK_DEPTH) inlineAccessorsStackWords = getMaxStackDepth(function->index, 1);
+    }
+
+    for (IntermediateFunction* function = functions; function != NULL; function = function->nextFunction) {
+
+        int functionWords = generatedWords;
+
+        if (function->isMain) generateMain(function);
+        else generateFunctionDeclaration(function);
+        if (function->memoizedArguments > 0) generateMemoizationLookup(function);
+
+        for (IntermediateInstruction* instruction = function->firstInstruction; instruction != NULL; instruction = instruction->nextInstruction) {
+            generateIntermediateInstruction(instruction);
+        }
+
+        if (function->memoizedArguments > 0) generateMemoizationStore(function);
+        if (function->isMain) generateMainEnd(function);
+        else generateFunctionEnd(function);
+
+        // Each identical function merged into this one would have taken as many bytes (two per word)
+        mergedFunctionCount += function->mergedFunctionCount;
+        savedBytes += function->mergedFunctionCount * (generatedWords - functionWords) * 2;
+
+    }
+
+    if (compilerOptions.showStatistics && compilerOptions.optimizationLevel >= 1) printf("Function merging: %d identical functions merged, %d bytes saved\n", mergedFunctionCount, savedBytes);
+
+    if (outputCode != outputFile) {
+        outlineProgram(outputCode, outputFile);
+        fclose(outputCode);
+        outputCode = outputFile;
+    }
+
+}
+
@@ -0,0 +1,155 @@
+/*!
+
+   CompilerOptions.c
+
+   Author: agent
+   Updated: 2026-10-19
+
+ */
+
+#include "CompilerOptions.h"
+
+CompilerOptions compilerOptions = {
+    0, DEFAULT_INLINE_ACCESSORS_BUDGET,
+    0,
+    0,
+    0, DEFAULT_MEMOIZATION_TABLE_SIZE,
+    0,
+    0,
+    0,
+    DEFAULT_UNROLL_FACTOR, DEFAULT_UNROLL_LIMIT,
+    DEFAULT_INLINE_LIMIT, DEFAULT_INLINE_SINGLE_CALL_LIMIT,
+    DEFAULT_SPECIALIZATION_LIMIT, DEFAULT_SPECIALIZATION_GROWTH,
+    DEFAULT_EVALUATION_LIMIT,
+    0,
+    0
+};
+
+// Returns 1 if the argument is the given option, optionally followed by "=value" (value is then set to it)
+static int matchOption(const char* argument, const char* option, const char** value) {
+
+    size_t length = strlen(option);
+
+    if (strncmp(argument, option, length) != 0) return 0;
+    if (argument[length] == '\0') {
+        *value = NULL;
+        return 1;
+    }
+    if (argument[length] == '=') {
+        *value = argument + length + 1;
+        return 1;
+    }
+
+    return 0;
+
+}
+
+// Reads the value of an option, which must be a positive integer. Returns 0 (printing an error) if it is not.
+static int parsePositiveValue(const char* option, const char* value, int* result) {
+
+    char* end;
+    long number = strtol(value, &end, 10);
+
+    if (end == value || *end != '\0' || number < 1 || number > INT_MAX) {
+        fprintf(stderr, "Invalid value for %s: %s (expected a positive integer)\n", option, value);
+        return 0;
+    }
+
+    *result = (int)number;
+    return 1;
+
+}
+
+int parseCompilerOptions(int argc, const char* argv[], const char* files[2]) {
+
+    int fileCount = 0;
+    const char* value;
+
+    for (int i = 1; i < argc; i++) {
+
+        // Input and output files
+        if (argv[i][0] != '-') {
+            if (fileCount == 2) return 0;
+            files[fileCount++] = argv[i];
+        }
+
+        // Inline variable accessors, with an optional code size budget
+        else if (matchOption(argv[i], "--inline-accessors", &value)) {
+            compilerOptions.inlineAccessors = 1;
+            if (value != NULL && !parsePositiveValue("--inline-accessors", value, &compilerOptions.inlineAccessorsBudget)) return 0;
+        }
+
+        // Light calling convention
+        else if (strcmp(argv[i], "--light-calls") == 0) compilerOptions.lightCalls = 1;
+
+        // Run-time array bounds checks
+        else if (strcmp(argv[i], "--bounds-check") == 0) compilerOptions.boundsCheck = 1;
+
+        // Memoization of pure recursive functions, with an optional table size
+        else if (matchOption(argv[i], "--memoize", &value)) {
+            compilerOptions.memoize = 1;
+            if (value != NULL && !parsePositiveValue("--memoize", value, &compilerOptions.memoizationTableSize)) return 0;
+        }
+
+        // Recursion depth of the stack
+        else if (matchOption(argv[i], "--recursion-depth", &value) && value != NULL) {
+            if (!parsePositiveValue("--recursion-depth", value, &compilerOptions.recursionDepth)) return 0;
+        }
+
+        // Optimization level
+        else if (strncmp(argv[i], "-O", 2) == 0 && argv[i][2] >= '0' && argv[i][2] <= '3' && argv[i][3] == '\0') {
+            compilerOptions.optimizationLevel = argv[i][2] - '0';
+            compilerOptions.optimizeSize = 0;
+        }
+
+        // Code size mode
+        else if (strcmp(argv[i], "-Os") == 0) {
+            compilerOptions.optimizationLevel = 2;
+            compilerOptions.optimizeSize = 1;
+        }
+
+        // Loop unrolling factor and size limit
+        else if (matchOption(argv[i], "--unroll-factor", &value) && value != NULL) {
+            if (!parsePositiveValue("--unroll-factor", value, &compilerOptions.unrollFactor)) return 0;
+        }
+        else if (matchOption(argv[i], "--unroll-limit", &value) && value != NULL) {
+            if (!parsePositiveValue("--unroll-limit", value, &compilerOptions.unrollLimit)) return 0;
+        }
+
+        // Function inlining size limits
+        else if (matchOption(argv[i], "--inline-limit", &value) && value != NULL) {
+            if (!parsePositiveValue("--inline-limit", value, &compilerOptions.inlineLimit)) return 0;
+        }
+        else if (matchOption(argv[i], "--inline-single-call-limit", &value) && value != NULL) {
+            if (!parsePositiveValue("--inline-single-call-limit", value, &compilerOptions.inlineSingleCallLimit)) return 0;
+        }
+
+        // Function specialization size limits
+        else if (matchOption(argv[i], "--specialize-limit", &value) && value != NULL) {
+            if (!parsePositiveValue("--specialize-limit", value, &compilerOptions.specializationLimit)) return 0;
+        }
+        else if (matchOption(argv[i], "--specialize-growth", &value) && value != NULL) {
+            if (!parsePositiveValue("--specialize-growth", value, &compilerOptions.specializationGrowth)) return 0;
+        }
+
+        // Compile-time evaluation step limit
+        else if (matchOption(argv[i], "--eval-limit", &value) && value != NULL) {
+            if (!parsePositiveValue("--eval-limit", value, &compilerOptions.evaluationLimit)) return 0;
+        }
+
+        // Optimization statistics
+        else if (strcmp(argv[i], "--stats") == 0) compilerOptions.showStatistics = 1;
+
+        // Call graph and function summaries
+        else if (strcmp(argv[i], "--dump-callgraph") == 0) compilerOptions.dumpCallGraph = 1;
+
+        else {
+            printf("Invalid option: %s\n", argv[i]);
+            return 0;
+        }
+
+    }
+
+    return fileCount == 2;
+
+}
@@ -0,0 +1,389 @@
+/*!
+
+   ControlFlowGraph.c
+
+   Author: agent
+   Updated: 2026-10-19
+
+ */
+
+#include "ControlFlowGraph.h"
+
+
+// BLOCKS
+
+static int endsBlock(IntermediateInstruction* instruction) {
+    return instruction->operation == icJump || isConditionalJump(instruction) || instruction->operation == icReturn;
+}
+
+static int startsBlock(IntermediateInstruction* instruction) {
+    return instruction->previousInstruction == NULL || instruction->operation == icLabel || endsBlock(instruction->previousInstruction);
+}
+
+static void addSuccessor(BasicBlock* block, int successor) {
+    if (block->successorCount == 1 && block->successors[0] == successor) return;
+    block->successors[block->successorCount++] = successor;
+}
+
+static void visitBlock(ControlFlowGraph* graph, int block, int* postorder, int* postorderCount) {
+    graph->blocks[block].isReachable = 1;
+    for (int i = 0; i < graph->blocks[block].successorCount; i++) {
+        int successor = graph->blocks[block].successors[i];
+        if (!graph->blocks[successor].isReachable) visitBlock(graph, successor, postorder, postorderCount);
+    }
+    postorder[(*postorderCount)++] = block;
+}
+
+
+// DOMINATORS
+
+static int intersectDominators(ControlFlowGraph* graph, int* order, int block, int otherBlock) {
+    while (block != otherBlock) {
+        while (order[block] > order[otherBlock]) block = graph->blocks[block].immediateDominator;
+        while (order[otherBlock] > order[block]) otherBlock = graph->blocks[otherBlock].immediateDominator;
+    }
+    return block;
+}
+
+// Iterative algorithm over the reverse postorder (Cooper, Harvey and Kennedy)
+static void computeDominators(ControlFlowGraph* graph) {
+
+    int* order = malloc(graph->blockCount * sizeof(int));
+    int changed = 1;
+
+    for (int i = 0; i < graph->reachableBlockCount; i++) order[graph->reversePostorder[i]] = i;
+    graph->blocks[0].immediateDominator = 0;
+
+    while (changed) {
+        changed = 0;
+        for (int i = 1; i < graph->reachableBlockCount; i++) {
+            BasicBlock* block = &graph->blocks[graph->reversePostorder[i]];
+            int dominator = -1;
+            for (int j = 0; j < block->predecessorCount; j++) {
+                int predecessor = block->predecessors[j];
+                if (graph->blocks[predecessor].immediateDominator < 0) continue;
+                dominator = dominator < 0 ? predecessor : intersectDominators(graph, order, predecessor, dominator);
+            }
+            if (block->immediateDominator != dominator) {
+                block->immediateDominator = dominator;
+                changed = 1;
+            }
+        }
+    }
+
+    free(order);
+
+}
+
+int dominates(ControlFlowGraph* graph, int block, int otherBlock) {
+    if (!graph->blocks[otherBlock].isReachable) return 0;
+    while (otherBlock != block && otherBlock != 0) otherBlock = graph->blocks[otherBlock].immediateDominator;
+    return otherBlock == block;
+}
+
+
+// LOOPS
+
+int isLoopHeader(ControlFlowGraph* graph, int block) {
+    if (!graph->blocks[block].isReachable) return 0;
+    for (int i = 0; i < graph->blocks[block].predecessorCount; i++) {
+        if (dominates(graph, block, graph->blocks[block].predecessors[i])) return 1;
+    }
+    return 0;
+}
+
+void findNaturalLoop(ControlFlowGraph* graph, int header, char* isLoopBlock) {
+
+    int* worklist = malloc(graph->blockCount * sizeof(int));
+    int worklistCount = 0;
+
+    memset(isLoopBlock, 0, graph->blockCount);
+    isLoopBlock[header] = 1;
+
+    // Blocks reaching a back edge without passing through the header
+    for (int i = 0; i < graph->blocks[header].predecessorCount; i++) {
+        int source = graph->blocks[header].predecessors[i];
+        if (dominates(graph, header, source) && !isLoopBlock[source]) {
+            isLoopBlock[source] = 1;
+            worklist[worklistCount++] = source;
+        }
+    }
+
+    while (worklistCount > 0) {
+        BasicBlock* block = &graph->blocks[worklist[--worklistCount]];
+        for (int i = 0; i < block->predecessorCount; i++) {
+            if (!isLoopBlock[block->predecessors[i]]) {
+                isLoopBlock[block->predecessors[i]] = 1;
+                worklist[worklistCount++] = block->predecessors[i];
+            }
+        }
+    }
+
+    free(worklist);
+
+}
+
+
+// GRAPH
+
+ControlFlowGraph* buildControlFlowGraph(IntermediateFunction* function) {
+
+    ControlFlowGraph* graph = calloc(1, sizeof(ControlFlowGraph));
+    int* labelBlocks = malloc((function->labelCounter + 1) * sizeof(int));
+    int* postorder;
+    int block;
+
+    graph->function = function;
+
+    // Count blocks: an empty entry block, which defines the values at the entry of the function, and the blocks
+    // delimited by the instructions
+    graph->blockCount = 1;
+    for (IntermediateInstruction* instruction = function->firstInstruction; instruction != NULL; instruction = instruction->nextInstruction) {
+        if (startsBlock(instruction)) graph->blockCount++;
+    }
+
+    graph->blocks = calloc(graph->blockCount, sizeof(BasicBlock));
+    for (block = 0; block < graph->blockCount; block++) graph->blocks[block].immediateDominator = -1;
+
+    // Delimit blocks
+    block = 0;
+    for (IntermediateInstruction* instruction = function->firstInstruction; instruction != NULL; instruction = instruction->nextInstruction) {
+        if (startsBlock(instruction)) graph->blocks[++block].firstInstruction = instruction;
+        graph->blocks[block].lastInstruction = instruction;
+        if (instruction->operation == icLabel) labelBlocks[instruction->label] = block;
+    }
+
+    // Successors: jump target, and the next block unless the block ends with an unconditional jump or a return
+    if (graph->blockCount > 1) addSuccessor(&graph->blocks[0], 1);
+    for (block = 1; block < graph->blockCount; block++) {
+        IntermediateInstruction* last = graph->blocks[block].lastInstruction;
+        if (last->operation != icJump && last->operation != icReturn && block + 1 < graph->blockCount) addSuccessor(&graph->blocks[block], block + 1);
+        if (last->operation == icJump || isConditionalJump(last)) addSuccessor(&graph->blocks[block], labelBlocks[last->label]);
+    }
+
+    // Predecessors
+    for (block = 0; block < graph->blockCount; block++) {
+        for (int i = 0; i < graph->blocks[block].successorCount; i++) graph->blocks[graph->blocks[block].successors[i]].predecessorCount++;
+    }
+    for (block = 0; block < graph->blockCount; block++) {
+        graph->blocks[block].predecessors = malloc((graph->blocks[block].predecessorCount + 1) * sizeof(int));
+        graph->blocks[block].predecessorCount = 0;
+    }
+    for (block = 0; block < graph->blockCount; block++) {
+        for (int i = 0; i < graph->blocks[block].successorCount; i++) {
+            BasicBlock* successor = &graph->blocks[graph->blocks[block].successors[i]];
+            successor->predecessors[successor->predecessorCount++] = block;
+        }
+    }
+
+    // Reverse postorder of the blocks reachable from the entry
+    postorder = malloc((graph->blockCount + 1) * sizeof(int));
+    graph->reversePostorder = malloc((graph->blockCount + 1) * sizeof(int));
+    visitBlock(graph, 0, postorder, &graph->reachableBlockCount);
+    for (int i = 0; i < graph->reachableBlockCount; i++) graph->reversePostorder[i] = postorder[graph->reachableBlockCount - 1 - i];
+
+    // Unreachable predecessors do not take part in dominance or SSA form
+    for (block = 0; block < graph->blockCount; block++) {
+        BasicBlock* current = &graph->blocks[block];
+        int count = 0;
+        for (int i = 0; i < current->predecessorCount; i++) {
+            if (graph->blocks[current->predecessors[i]].isReachable) current->predecessors[count++] = current->predecessors[i];
+        }
+        current->predecessorCount = count;
+    }
+
+    computeDominators(graph);
+
+    free(postorder);
+    free(labelBlocks);
+
+    return graph;
+
+}
+
+IntermediateInstruction* getBlockEnd(BasicBlock* block) {
+    return block->lastInstruction != NULL ? block->lastInstruction->nextInstruction : NULL;
+}
+
+int getBlockStartingAt(ControlFlowGraph* graph, IntermediateInstruction* instruction) {
+    for (int block = 1; block < graph->blockCount; block++) {
+        if (graph->blocks[block].firstInstruction == instruction) return block;
+    }
+    return -1;
+}
+
+
+// SSA FORM
+
+// Returns the slot of the operand if it is a variable of the SSA form, -1 otherwise
+static int getSSASlot(ControlFlowGraph* graph, Operand operand) {
+    if (operand.type != opdtVariable && operand.type != opdtTemporary) return -1;
+    if (operand.value < 0 || operand.value >= graph->slotCount || !graph->isSSASlot[operand.value]) return -1;
+    return operand.value;
+}
+
+static void excludeSlots(ControlFlowGraph* graph, Operand operand, int size) {
+    for (int slot = operand.value; slot < operand.value + size; slot++) {
+        if (slot >= 0 && slot < graph->slotCount) graph->isSSASlot[slot] = 0;
+    }
+}
+
+static int newSSAValue(ControlFlowGraph* graph, int slot, int block, IntermediateInstruction* definition, int phiFunction) {
+    graph->values = realloc(graph->values, (graph->valueCount + 1) * sizeof(SSAValue));
+    graph->values[graph->valueCount].slot = slot;
+    graph->values[graph->valueCount].block = block;
+    graph->values[graph->valueCount].definition = definition;
+    graph->values[graph->valueCount].phiFunction = phiFunction;
+    return graph->valueCount++;
+}
+
+static void addPhiFunction(BasicBlock* block, int slot) {
+    block->phiFunctions = realloc(block->phiFunctions, (block->phiFunctionCount + 1) * sizeof(PhiFunction));
+    block->phiFunctions[block->phiFunctionCount].slot = slot;
+    block->phiFunctions[block->phiFunctionCount].value = NO_VALUE;
+    block->phiFunctions[block->phiFunctionCount].arguments = malloc((block->predecessorCount + 1) * sizeof(int));
+    block->phiFunctionCount++;
+}
+
+// Renames the definitions and uses of the block and of the blocks it dominates; currentValues holds the value of each slot
+static void renameBlock(ControlFlowGraph* graph, int block, int* currentValues) {
+
+    BasicBlock* current = &graph->blocks[block];
+    int* savedValues = malloc(graph->slotCount * sizeof(int));
+    int slot;
+
+    memcpy(savedValues, currentValues, graph->slotCount * sizeof(int));
+
+    for (int i = 0; i < current->phiFunctionCount; i++) {
+        current->phiFunctions[i].value = newSSAValue(graph, current->phiFunctions[i].slot, block, NULL, i);
+        currentValues[current->phiFunctions[i].slot] = current->phiFunctions[i].value;
+    }
+
+    for (IntermediateInstruction* instruction = current->firstInstruction; instruction != getBlockEnd(current); instruction = instruction->nextInstruction) {
+        instruction->leftValue = instruction->rightValue = instruction->resultValue = NO_VALUE;
+        if (readsLeftOperand(instruction) && (slot = getSSASlot(graph, instruction->left)) >= 0) instruction->leftValue = currentValues[slot];
+        if (readsRightOperand(instruction) && (slot = getSSASlot(graph, instruction->right)) >= 0) instruction->rightValue = currentValues[slot];
+        if (writesResult(instruction) && (slot = getSSASlot(graph, instruction->result)) >= 0) {
+            instruction->resultValue = newSSAValue(graph, slot, block, instruction, -1);
+            currentValues[slot] = instruction->resultValue;
+        }
+    }
+
+    // Arguments of the phi functions of the successors
+    for (int i = 0; i < current->successorCount; i++) {
+        BasicBlock* successor = &graph->blocks[current->successors[i]];
+        int predecessorIndex;
+        for (predecessorIndex = 0; successor->predecessors[predecessorIndex] != block; predecessorIndex++);
+        for (int j = 0; j < successor->phiFunctionCount; j++) successor->phiFunctions[j].arguments[predecessorIndex] = currentValues[successor->phiFunctions[j].slot];
+    }
+
+    // Children in the dominator tree
+    for (int i = 1; i < graph->reachableBlockCount; i++) {
+        int child = graph->reversePostorder[i];
+        if (graph->blocks[child].immediateDominator == block) renameBlock(graph, child, currentValues);
+    }
+
+    memcpy(currentValues, savedValues, graph->slotCount * sizeof(int));
+    free(savedValues);
+
+}
+
+void buildStaticSingleAssignmentForm(ControlFlowGraph* graph) {
+
+    int blockCount = graph->blockCount;
+    int slotCount = graph->function->activationRecordSize;
+    char* definesSlot;
+    char* dominanceFrontier;
+    char* hasPhiFunction;
+    int* worklist;
+    int* currentValues;
+
+    graph->slotCount = slotCount;
+    graph->isSSASlot = malloc(slotCount + 1);
+    for (int slot = 0; slot < slotCount; slot++) graph->isSSASlot[slot] = slot >= 2;
+
+    // Slots accessed as blocks (structs and arrays passed or returned) or through addresses (arrays indexed at run
+    // time) are not variables of the SSA form
+    for (int block = 0; block < blockCount; block++) {
+        for (IntermediateInstruction* instruction = graph->blocks[block].firstInstruction; instruction != getBlockEnd(&graph->blocks[block]); instruction = instruction->nextInstruction) {
+            if (instruction->operation == icAddress) excludeSlots(graph, instruction->left, instruction->size);
+            if (readsLeftOperand(instruction) && getLeftOperandSize(instruction) > 1) excludeSlots(graph, instruction->left, getLeftOperandSize(instruction));
+            if (writesResult(instruction) && getResultSize(instruction) > 1) excludeSlots(graph, instruction->result, getResultSize(instruction));
+        }
+    }
+
+    // Blocks defining each slot (the entry defines all of them)
+    definesSlot = calloc(blockCount * slotCount + 1, sizeof(char));
+    for (int slot = 0; slot < slotCount; slot++) definesSlot[slot] = 1;
+    for (int block = 0; block < blockCount; block++) {
+        if (!graph->blocks[block].isReachable) continue;
+        for (IntermediateInstruction* instruction = graph->blocks[block].firstInstruction; instruction != getBlockEnd(&graph->blocks[block]); instruction = instruction->nextInstruction) {
+            int slot;
+            if (writesResult(instruction) && (slot = getSSASlot(graph, instruction->result)) >= 0) definesSlot[block * slotCount + slot] = 1;
+        }
+    }
+
+    // Dominance frontiers
+    dominanceFrontier = calloc(blockCount * blockCount + 1, sizeof(char));
+    for (int block = 0; block < blockCount; block++) {
+        BasicBlock* current = &graph->blocks[block];
+        if (!current->isReachable || current->predecessorCount < 2) continue;
+        for (int i = 0; i < current->predecessorCount; i++) {
+            int runner = current->predecessors[i];
+            while (runner != current->immediateDominator) {
+                dominanceFrontier[runner * blockCount + block] = 1;
+                runner = graph->blocks[runner].immediateDominator;
+            }
+        }
+    }
+
+    // Place phi functions in the iterated dominance frontier of the definitions of each slot
+    hasPhiFunction = malloc(blockCount);
+    worklist = malloc(blockCount * sizeof(int));
+    for (int slot = 0; slot < slotCount; slot++) {
+
+        int worklistCount = 0;
+        if (!graph->isSSASlot[slot]) continue;
+
+        memset(hasPhiFunction, 0, blockCount);
+        for (int block = 0; block < blockCount; block++) {
+            if (definesSlot[block * slotCount + slot]) worklist[worklistCount++] = block;
+        }
+
+        while (worklistCount > 0) {
+            int block = worklist[--worklistCount];
+            for (int frontier = 0; frontier < blockCount; frontier++) {
+                if (!dominanceFrontier[block * blockCount + frontier] || hasPhiFunction[frontier]) continue;
+                addPhiFunction(&graph->blocks[frontier], slot);
+                hasPhiFunction[frontier] = 1;
+                if (!definesSlot[frontier * slotCount + slot]) worklist[worklistCount++] = frontier;
+            }
+        }
+
+    }
+
+    // Rename definitions and uses, starting with the values at the entry of the function
+    currentValues = malloc(slotCount * sizeof(int));
+    for (int slot = 0; slot < slotCount; slot++) currentValues[slot] = graph->isSSASlot[slot] ? newSSAValue(graph, slot, 0, NULL, -1) : NO_VALUE;
+    renameBlock(graph, 0, currentValues);
+
+    free(currentValues);
+    free(worklist);
+    free(hasPhiFunction);
+    free(dominanceFrontier);
+    free(definesSlot);
+
+}
+
+void freeControlFlowGraph(ControlFlowGraph* graph) {
+    for (int block = 0; block < graph->blockCount; block++) {
+        for (int i = 0; i < graph->blocks[block].phiFunctionCount; i++) free(graph->blocks[block].phiFunctions[i].arguments);
+        free(graph->blocks[block].phiFunctions);
+        free(graph->blocks[block].predecessors);
+    }
+    free(graph->blocks);
+    free(graph->reversePostorder);
+    free(graph->isSSASlot);
+    free(graph->values);
+    free(graph);
+}
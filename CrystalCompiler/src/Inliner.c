@@ -0,0 +1,149 @@
+/*!
+
+   Inliner.c
+
+   Author: agent
+   Updated: 2026-10-19
+
+ */
+
+#include "Inliner.h"
+
+// Largest label of a function after inlining, so the labels of the code generator still fit in two digits
+#define MAX_INLINED_LABEL 0x80
+
+// Number of calls of each function in the program, indexed by the function index
+static int* countCalls(IntermediateFunction* functions, int functionCount) {
+
+    int* callCounts = calloc(functionCount, sizeof(int));
+
+    for (IntermediateFunction* function = functions; function != NULL; function = function->nextFunction) {
+        for (IntermediateInstruction* instruction = function->firstInstruction; instruction != NULL; instruction = instruction->nextInstruction) {
+            if (instruction->operation == icFunctionCall) callCounts[instruction->function]++;
+        }
+    }
+
+    return callCounts;
+
+}
+
+// Returns 1 if the call can be inlined in the caller: the called function is not recursive, it fits the size limit
+// and it only receives and returns scalars. Its arguments are the parameters passed just before the call.
+static int canInlineCall(IntermediateFunction* caller, IntermediateInstruction* call, IntermediateFunction* callee, int callCount) {
+
+    int sizeLimit = compilerOptions.inlineLimit;
+
+    if (callCount == 1 && compilerOptions.inlineSingleCallLimit > sizeLimit) sizeLimit = compilerOptions.inlineSingleCallLimit;
+
+    if (callee->isMain || callee == caller || isRecursiveFunction(callee->index) || callee->returnValueSize > 1) return 0;
+    if (getIntermediateFunctionSize(callee) > sizeLimit) return 0;
+    if (caller->labelCounter + callee->labelCounter + 1 > MAX_INLINED_LABEL) return 0;
+
+    for (IntermediateInstruction* instruction = call->previousInstruction; instruction != NULL && instruction->operation == icParameter && instruction->function == callee->index; instruction = instruction->previousInstruction) {
+        if (instruction->size != 1) return 0;
+    }
+
+    return 1;
+
+}
+
+// Slots of the activation record of the called function are moved to the end of the caller's one
+static void relocateOperand(Operand* operand, int base) {
+    if (operand->type == opdtVariable || operand->type == opdtTemporary || operand->type == opdtElement) operand->value += base;
+}
+
+// Replaces the call by a copy of the body of the called function. Slots 0 and 1 (return address and base pointer)
+// are not needed, so the slots of the called function start at base + 2.
+static void inlineCall(IntermediateFunction* caller, IntermediateInstruction* call, IntermediateFunction* callee) {
+
+    int base = caller->activationRecordSize - 2;
+    int labelOffset = caller->labelCounter;
+    int continuationLabel;
+    int jumpsToContinuation = 0;
+    IntermediateInstruction* copy;
+
+    caller->activationRecordSize += callee->activationRecordSize - 2;
+    caller->labelCounter += callee->labelCounter;
+    continuationLabel = newIntermediateLabel(caller);
+
+    // Arguments are copied to the slots of the parameters
+    for (IntermediateInstruction* instruction = call->previousInstruction; instruction != NULL && instruction->operation == icParameter && instruction->function == callee->index; instruction = instruction->previousInstruction) {
+        Operand parameter = { opdtVariable, instruction->left.operandSymbolType, base + instruction->address };
+        instruction->operation = icAttribution;
+        instruction->result = parameter;
+    }
+
+    for (IntermediateInstruction* instruction = callee->firstInstruction; instruction != NULL; instruction = instruction->nextInstruction) {
+
+        // Return: the returned value becomes the result of the call
+        if (instruction->operation == icReturn) {
+            if (instruction->size > 0) {
+                copy = insertIntermediateInstruction(caller, icAttribution, call);
+                copy->result = call->result;
+                copy->left = instruction->left;
+                relocateOperand(&copy->left, base);
+            }
+            if (instruction->nextInstruction != NULL) {
+                copy = insertIntermediateInstruction(caller, icJump, call);
+                copy->label = continuationLabel;
+                copy->comment = "Return";
+                jumpsToContinuation = 1;
+            }
+            continue;
+        }
+
+        copy = copyIntermediateInstruction(caller, instruction, call);
+        relocateOperand(&copy->result, base);
+        relocateOperand(&copy->left, base);
+        relocateOperand(&copy->right, base);
+        if (copy->operation == icLabel || copy->operation == icJump || isConditionalJump(copy)) copy->label += labelOffset;
+        if (copy->operation == icFunctionCall) addCallGraphEdge(caller->index, copy->function);
+
+    }
+
+    // The last return falls through to the instruction following the call
+    if (jumpsToContinuation) {
+        copy = insertIntermediateInstruction(caller, icLabel, call);
+        copy->label = continuationLabel;
+        copy->comment = "End of inlined call";
+    }
+    removeIntermediateInstruction(caller, call);
+
+}
+
+// Functions are declared before they are called, so the calls of a function are inlined before it is copied
+int inlineFunctionCalls(IntermediateFunction* functions) {
+
+    int functionCount = 0;
+    int* callCounts;
+    int inlinedCalls = 0;
+
+    for (IntermediateFunction* function = functions; function != NULL; function = function->nextFunction) functionCount++;
+    callCounts = countCalls(functions, functionCount);
+
+    for (IntermediateFunction* function = functions; function != NULL; function = function->nextFunction) {
+
+        IntermediateInstruction* nextInstruction;
+
+        for (IntermediateInstruction* instruction = function->firstInstruction; instruction != NULL; instruction = nextInstruction) {
+
+            IntermediateFunction* callee;
+
+            nextInstruction = instruction->nextInstruction;
+            if (instruction->operation != icFunctionCall) continue;
+
+            callee = getIntermediateFunction(instruction->function);
+            if (!canInlineCall(function, instruction, callee, callCounts[callee->index])) continue;
+
+            inlineCall(function, instruction, callee);
+            inlinedCalls++;
+
+        }
+
+    }
+
+    free(callCounts);
+
+    return inlinedCalls;
+
+}
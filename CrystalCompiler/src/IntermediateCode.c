@@ -0,0 +1,573 @@
+/*!
+
+   IntermediateCode.c
+
+   Author: agent
+   Updated: 2026-10-19
+
+ */
+
+#include "IntermediateCode.h"
+#include "IntegerStack.h"
+
+// Recorded functions
+static IntermediateFunction* firstFunction = NULL;
+static IntermediateFunction* lastFunction = NULL;
+static int functionCounter = 0;
+
+// Label management for if and while commands
+static IntegerStack* labelStack = NULL;
+
+// For commands being recorded: their condition and step are parsed before the body, but run after it
+typedef struct ForCommand {
+    int loopLabel;
+    int endLabel;
+    IntermediateInstruction* conditionBegin;    // Last instruction before the condition
+    IntermediateInstruction* firstConditionInstruction;
+    IntermediateInstruction* test;
+    IntermediateInstruction* firstStepInstruction;
+    IntermediateInstruction* lastStepInstruction;
+    struct ForCommand* previousCommand;
+} ForCommand;
+
+static ForCommand* forCommandStack = NULL;
+
+
+// FUNCTIONS
+
+int beginIntermediateFunction(char* name, int isMain) {
+
+    IntermediateFunction* function = malloc(sizeof(IntermediateFunction));
+
+    function->index = functionCounter++;
+    function->name = name;
+    function->isMain = isMain;
+    function->activationRecordSize = 2;
+    function->returnValueSize = 0;
+    function->firstParameterSize = 0;
+    function->labelCounter = 0;
+    function->hasStaticActivationRecord = isMain;
+    function->usesLightCallingConvention = 0;
+    function->isPure = 0;
+    function->memoizedArguments = 0;
+    function->memoizationSlot = 0;
+    function->mergedFunctionCount = 0;
+    function->firstInstruction = NULL;
+    function->lastInstruction = NULL;
+    function->nextFunction = NULL;
+
+    if (firstFunction == NULL) firstFunction = function;
+    else lastFunction->nextFunction = function;
+    lastFunction = function;
+
+    return function->index;
+
+}
+
+void endIntermediateFunction(int activationRecordSize, int returnValueSize) {
+    lastFunction->activationRecordSize = activationRecordSize;
+    lastFunction->returnValueSize = returnValueSize;
+}
+
+IntermediateFunction* getIntermediateFunctions() {
+    return firstFunction;
+}
+
+IntermediateFunction* getIntermediateFunction(int index) {
+    IntermediateFunction* function;
+    for (function = firstFunction; function != NULL && function->index != index; function = function->nextFunction);
+    return function;
+}
+
+int newIntermediateLabel(IntermediateFunction* function) {
+    return function->labelCounter++;
+}
+
+// Copy of the function and of its instructions, which is not part of the program until it is inserted
+IntermediateFunction* copyIntermediateFunction(IntermediateFunction* function) {
+
+    IntermediateFunction* copy = malloc(sizeof(IntermediateFunction));
+
+    *copy = *function;
+    copy->index = -1;
+    copy->mergedFunctionCount = 0;
+    copy->firstInstruction = NULL;
+    copy->lastInstruction = NULL;
+    copy->nextFunction = NULL;
+
+    for (IntermediateInstruction* instruction = function->firstInstruction; instruction != NULL; instruction = instruction->nextInstruction) {
+        IntermediateInstruction* instructionCopy = malloc(sizeof(IntermediateInstruction));
+        *instructionCopy = *instruction;
+        instructionCopy->previousInstruction = copy->lastInstruction;
+        instructionCopy->nextInstruction = NULL;
+        if (copy->firstInstruction == NULL) copy->firstInstruction = instructionCopy;
+        else copy->lastInstruction->nextInstruction = instructionCopy;
+        copy->lastInstruction = instructionCopy;
+    }
+
+    return copy;
+
+}
+
+// Gives the function the next index and inserts it in the program after previousFunction
+void insertIntermediateFunction(IntermediateFunction* function, IntermediateFunction* previousFunction) {
+
+    function->index = functionCounter++;
+    function->nextFunction = previousFunction->nextFunction;
+    previousFunction->nextFunction = function;
+    if (lastFunction == previousFunction) lastFunction = function;
+
+}
+
+void freeIntermediateFunction(IntermediateFunction* function) {
+
+    IntermediateInstruction* nextInstruction;
+
+    for (IntermediateInstruction* instruction = function->firstInstruction; instruction != NULL; instruction = nextInstruction) {
+        nextInstruction = instruction->nextInstruction;
+        free(instruction);
+    }
+    free(function);
+
+}
+
+// Removes the function from the program and frees it
+void removeIntermediateFunction(IntermediateFunction* function) {
+
+    IntermediateFunction* previousFunction = NULL;
+
+    for (IntermediateFunction* other = firstFunction; other != function; other = other->nextFunction) previousFunction = other;
+
+    if (previousFunction == NULL) firstFunction = function->nextFunction;
+    else previousFunction->nextFunction = function->nextFunction;
+    if (lastFunction == function) lastFunction = previousFunction;
+
+    freeIntermediateFunction(function);
+
+}
+
+// Number of instructions of the function, not counting its labels
+int getIntermediateFunctionSize(IntermediateFunction* function) {
+
+    int size = 0;
+
+    for (IntermediateInstruction* instruction = function->firstInstruction; instruction != NULL; instruction = instruction->nextInstruction) {
+        if (instruction->operation != icLabel) size++;
+    }
+
+    return size;
+
+}
+
+
+// INSTRUCTIONS
+
+// Creates a new instruction at the end of the function being recorded
+static IntermediateInstruction* appendInstruction(IntermediateOperation operation) {
+
+    IntermediateInstruction* instruction = calloc(1, sizeof(IntermediateInstruction));
+
+    instruction->operation = operation;
+    instruction->previousInstruction = lastFunction->lastInstruction;
+
+    if (lastFunction->firstInstruction == NULL) lastFunction->firstInstruction = instruction;
+    else lastFunction->lastInstruction->nextInstruction = instruction;
+    lastFunction->lastInstruction = instruction;
+
+    return instruction;
+
+}
+
+// Removes the instruction from the list of the function, without freeing it
+static void unlinkInstruction(IntermediateFunction* function, IntermediateInstruction* instruction) {
+
+    if (instruction->previousInstruction != NULL) instruction->previousInstruction->nextInstruction = instruction->nextInstruction;
+    else function->firstInstruction = instruction->nextInstruction;
+
+    if (instruction->nextInstruction != NULL) instruction->nextInstruction->previousInstruction = instruction->previousInstruction;
+    else function->lastInstruction = instruction->previousInstruction;
+
+}
+
+void removeIntermediateInstruction(IntermediateFunction* function, IntermediateInstruction* instruction) {
+    unlinkInstruction(function, instruction);
+    free(instruction);
+}
+
+// Inserts the instruction in the list of the function, before nextInstruction
+static void linkInstruction(IntermediateFunction* function, IntermediateInstruction* instruction, IntermediateInstruction* nextInstruction) {
+
+    instruction->previousInstruction = nextInstruction->previousInstruction;
+    instruction->nextInstruction = nextInstruction;
+
+    if (nextInstruction->previousInstruction != NULL) nextInstruction->previousInstruction->nextInstruction = instruction;
+    else function->firstInstruction = instruction;
+    nextInstruction->previousInstruction = instruction;
+
+}
+
+void moveIntermediateInstruction(IntermediateFunction* function, IntermediateInstruction* instruction, IntermediateInstruction* nextInstruction) {
+    unlinkInstruction(function, instruction);
+    linkInstruction(function, instruction, nextInstruction);
+}
+
+// Creates a new instruction before nextInstruction, its operands to be filled in
+IntermediateInstruction* insertIntermediateInstruction(IntermediateFunction* function, IntermediateOperation operation, IntermediateInstruction* nextInstruction) {
+    IntermediateInstruction* instruction = calloc(1, sizeof(IntermediateInstruction));
+    instruction->operation = operation;
+    linkInstruction(function, instruction, nextInstruction);
+    return instruction;
+}
+
+IntermediateInstruction* copyIntermediateInstruction(IntermediateFunction* function, IntermediateInstruction* instruction, IntermediateInstruction* nextInstruction) {
+    IntermediateInstruction* copy = malloc(sizeof(IntermediateInstruction));
+    *copy = *instruction;
+    linkInstruction(function, copy, nextInstruction);
+    return copy;
+}
+
+int isConditionalJump(IntermediateInstruction* instruction) {
+    return instruction->operation == icJumpIfFalse || instruction->operation == icJumpIfTrue;
+}
+
+// Conditional jump which compares its operands instead of testing a boolean
+int isComparisonJump(IntermediateInstruction* instruction) {
+    return isConditionalJump(instruction) && instruction->operator >= oprSmallerOrEqualThan && instruction->operator <= oprDifferent;
+}
+
+int readsLeftOperand(IntermediateInstruction* instruction) {
+    switch (instruction->operation) {
+        case icAttribution:
+        case icArithmetic:
+        case icRelational:
+        case icLogical:
+        case icLoad:
+        case icStore:
+        case icBoundsCheck:
+        case icJumpIfFalse:
+        case icJumpIfTrue:
+        case icParameter:
+        case icPrint:
+            return 1;
+        case icReturn:
+            return instruction->size > 0;
+        default:
+            return 0;
+    }
+}
+
+int readsRightOperand(IntermediateInstruction* instruction) {
+    return instruction->operation == icArithmetic || instruction->operation == icRelational || instruction->operation == icLogical || instruction->operation == icStore || isComparisonJump(instruction);
+}
+
+int writesResult(IntermediateInstruction* instruction) {
+    switch (instruction->operation) {
+        case icAttribution:
+        case icArithmetic:
+        case icRelational:
+        case icLogical:
+        case icAddress:
+        case icLoad:
+        case icScan:
+            return 1;
+        case icFunctionCall:
+            return instruction->size > 0;
+        default:
+            return 0;
+    }
+}
+
+// Number of slots read through the left operand
+int getLeftOperandSize(IntermediateInstruction* instruction) {
+    return instruction->operation == icParameter || instruction->operation == icReturn ? instruction->size : 1;
+}
+
+// Number of slots written through the result
+int getResultSize(IntermediateInstruction* instruction) {
+    return instruction->operation == icFunctionCall ? instruction->size : 1;
+}
+
+static void appendLabel(int label, const char* comment) {
+    IntermediateInstruction* instruction = appendInstruction(icLabel);
+    instruction->label = label;
+    instruction->comment = comment;
+}
+
+static void appendJump(IntermediateOperation operation, int label, Operand* condition, const char* comment) {
+    IntermediateInstruction* instruction = appendInstruction(operation);
+    instruction->label = label;
+    instruction->comment = comment;
+    if (condition != NULL) instruction->left = *condition;
+}
+
+
+// OPERATIONS
+
+void appendAttribution(Operand leftOperand, Operand rightOperand) {
+    IntermediateInstruction* instruction = appendInstruction(icAttribution);
+    instruction->result = leftOperand;
+    instruction->left = rightOperand;
+}
+
+void appendOperation(IntermediateOperation operation, Operator operator, Operand leftOperand, Operand rightOperand, int resultAddressOffset) {
+    IntermediateInstruction* instruction = appendInstruction(operation);
+    Operand result = { opdtTemporary, operation == icArithmetic ? stInt : stBoolean, resultAddressOffset };
+    instruction->operator = operator;
+    instruction->result = result;
+    instruction->left = leftOperand;
+    instruction->right = rightOperand;
+}
+
+
+// ARRAY ELEMENTS
+
+void appendAddress(Operand variable, int size, int position, int resultAddressOffset) {
+    IntermediateInstruction* instruction = appendInstruction(icAddress);
+    Operand result = { opdtTemporary, stInt, resultAddressOffset };
+    instruction->result = result;
+    instruction->left = variable;
+    instruction->address = position;
+    instruction->size = size;
+}
+
+// Constant indexes and fields accessed after an index known at run time: the slots are added to the position of
+// the address the element address was computed from, following the additions of the scaled indexes back to it
+void offsetElementAddress(Operand address, int slots) {
+    for (IntermediateInstruction* instruction = lastFunction->lastInstruction; instruction != NULL; instruction = instruction->previousInstruction) {
+        if (!writesResult(instruction) || instruction->result.value != address.value) continue;
+        if (instruction->operation == icAddress) {
+            instruction->address += slots;
+            return;
+        }
+        address = instruction->left;
+    }
+}
+
+void appendLoad(Operand address, int resultAddressOffset) {
+    IntermediateInstruction* instruction = appendInstruction(icLoad);
+    Operand result = { opdtTemporary, address.operandSymbolType, resultAddressOffset };
+    instruction->result = result;
+    instruction->left = address;
+    instruction->left.type = opdtTemporary;
+}
+
+void appendStore(Operand address, Operand value) {
+    IntermediateInstruction* instruction = appendInstruction(icStore);
+    instruction->left = value;
+    instruction->right = address;
+    instruction->right.type = opdtTemporary;
+}
+
+void appendBoundsCheck(Operand index, int size) {
+    IntermediateInstruction* instruction = appendInstruction(icBoundsCheck);
+    instruction->left = index;
+    instruction->size = size;
+}
+
+
+// IF
+
+void appendIfCommand(Operand condition) {
+    int elseLabel = newIntermediateLabel(lastFunction);
+    pushIntegerToStack(&labelStack, elseLabel);
+    appendJump(icJumpIfFalse, elseLabel, &condition, "If command");
+}
+
+void appendElseCommand() {
+
+    int elseLabel;
+    int endLabel = newIntermediateLabel(lastFunction);
+
+    popIntegerFromStack(&labelStack, &elseLabel);
+    pushIntegerToStack(&labelStack, endLabel);
+
+    appendJump(icJump, endLabel, NULL, NULL);
+    appendLabel(elseLabel, "Else");
+
+}
+
+void appendEndIf() {
+    int endLabel;
+    popIntegerFromStack(&labelStack, &endLabel);
+    appendLabel(endLabel, "Endif");
+}
+
+
+// WHILE
+
+void appendWhileCommand() {
+    int whileLabel = newIntermediateLabel(lastFunction);
+    pushIntegerToStack(&labelStack, whileLabel);
+    appendLabel(whileLabel, "While");
+}
+
+void appendWhileTest(Operand condition) {
+    int endLabel = newIntermediateLabel(lastFunction);
+    pushIntegerToStack(&labelStack, endLabel);
+    appendJump(icJumpIfFalse, endLabel, &condition, "While Condition");
+}
+
+void appendEndWhile() {
+
+    int whileLabel;
+    int endLabel;
+
+    popIntegerFromStack(&labelStack, &endLabel);
+    popIntegerFromStack(&labelStack, &whileLabel);
+
+    appendJump(icJump, whileLabel, NULL, NULL);
+    appendLabel(endLabel, "Endwhile");
+
+}
+
+
+// FOR
+
+// A for command is lowered to a guarded loop testing its condition at the bottom:
+//
+//          init
+//          jump to end if not condition        (guard)
+//    loop: body
+//          step
+//          jump to loop if condition
+//    end:
+//
+// A condition which is a single comparison is made a comparison jump, and a step computing an operation into a
+// temporary variable and copying it to a variable computes it directly into the variable. The usual counted
+// loop, for (i = a; i < b; i = i + k), then keeps i in its own slot and runs a single increment and test per
+// iteration.
+
+void appendForCondition() {
+    ForCommand* command = calloc(1, sizeof(ForCommand));
+    command->conditionBegin = lastFunction->lastInstruction;
+    command->previousCommand = forCommandStack;
+    forCommandStack = command;
+}
+
+void appendForTest(Operand condition) {
+
+    ForCommand* command = forCommandStack;
+    IntermediateInstruction* first = command->conditionBegin != NULL ? command->conditionBegin->nextInstruction : lastFunction->firstInstruction;
+    IntermediateInstruction* comparison = lastFunction->lastInstruction;
+
+    command->endLabel = newIntermediateLabel(lastFunction);
+    command->loopLabel = newIntermediateLabel(lastFunction);
+
+    // Single comparison: compared by the jumps
+    if (first != NULL && first == comparison && comparison->operation == icRelational && condition.type == opdtTemporary && comparison->result.value == condition.value) {
+        appendJump(icJumpIfFalse, command->endLabel, &comparison->left, "For Condition");
+        lastFunction->lastInstruction->operator = comparison->operator;
+        lastFunction->lastInstruction->right = comparison->right;
+        removeIntermediateInstruction(lastFunction, comparison);
+        first = NULL;
+    } else appendJump(icJumpIfFalse, command->endLabel, &condition, "For Condition");
+
+    command->test = lastFunction->lastInstruction;
+    if (first != command->test) command->firstConditionInstruction = first;
+
+}
+
+void appendForStep() {
+
+    ForCommand* command = forCommandStack;
+    IntermediateInstruction* last = lastFunction->lastInstruction;
+
+    if (last == command->test) {
+        appendLabel(command->loopLabel, "For");
+        return;
+    }
+
+    // Operation followed by a copy of its result to a variable
+    if (last->operation == icAttribution && last->left.type == opdtTemporary && last->previousInstruction != command->test) {
+        IntermediateInstruction* operation = last->previousInstruction;
+        if ((operation->operation == icArithmetic || operation->operation == icRelational || operation->operation == icLogical) && operation->result.value == last->left.value) {
+            operation->result = last->result;
+            removeIntermediateInstruction(lastFunction, last);
+        }
+    }
+
+    // Detach the step, which is appended after the body
+    command->firstStepInstruction = command->test->nextInstruction;
+    command->lastStepInstruction = lastFunction->lastInstruction;
+    command->firstStepInstruction->previousInstruction = NULL;
+    command->test->nextInstruction = NULL;
+    lastFunction->lastInstruction = command->test;
+
+    appendLabel(command->loopLabel, "For");
+
+}
+
+void appendEndFor() {
+
+    ForCommand* command = forCommandStack;
+
+    // Step
+    if (command->firstStepInstruction != NULL) {
+        command->firstStepInstruction->previousInstruction = lastFunction->lastInstruction;
+        lastFunction->lastInstruction->nextInstruction = command->firstStepInstruction;
+        lastFunction->lastInstruction = command->lastStepInstruction;
+    }
+
+    // Condition and test
+    if (command->firstConditionInstruction != NULL) {
+        for (IntermediateInstruction* instruction = command->firstConditionInstruction; instruction != command->test; instruction = instruction->nextInstruction) {
+            IntermediateInstruction* copy = appendInstruction(instruction->operation);
+            IntermediateInstruction* previousInstruction = copy->previousInstruction;
+            *copy = *instruction;
+            copy->previousInstruction = previousInstruction;
+            copy->nextInstruction = NULL;
+        }
+    }
+    appendJump(icJumpIfTrue, command->loopLabel, &command->test->left, "For Condition");
+    lastFunction->lastInstruction->operator = command->test->operator;
+    lastFunction->lastInstruction->right = command->test->right;
+
+    appendLabel(command->endLabel, "Endfor");
+
+    forCommandStack = command->previousCommand;
+    free(command);
+
+}
+
+
+// FUNCTION CALL
+
+void appendFunctionReturn(Operand* returnOperand, int returnValueSize) {
+    IntermediateInstruction* instruction = appendInstruction(icReturn);
+    if (returnOperand != NULL) {
+        instruction->left = *returnOperand;
+        instruction->size = returnValueSize;
+    }
+}
+
+void appendPassingParameter(Operand parameter, int functionAddress, int address, int size) {
+    IntermediateInstruction* instruction = appendInstruction(icParameter);
+    instruction->left = parameter;
+    instruction->function = functionAddress;
+    instruction->address = address;
+    instruction->size = size;
+}
+
+void appendFunctionCall(int functionAddress, int resultAddressOffset, int returnValueSize) {
+    IntermediateInstruction* instruction = appendInstruction(icFunctionCall);
+    Operand result = { opdtTemporary, -1, resultAddressOffset };
+    instruction->result = result;
+    instruction->function = functionAddress;
+    instruction->size = returnValueSize;
+}
+
+
+// SCAN AND PRINT
+
+void appendScan(SymbolType type, int resultAddressOffset) {
+    IntermediateInstruction* instruction = appendInstruction(icScan);
+    Operand result = { opdtVariable, type, resultAddressOffset };
+    instruction->result = result;
+    instruction->dataType = type;
+}
+
+void appendPrint(SymbolType type, Operand operand) {
+    IntermediateInstruction* instruction = appendInstruction(icPrint);
+    instruction->left = operand;
+    instruction->dataType = type;
+}
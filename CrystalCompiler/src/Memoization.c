@@ -0,0 +1,103 @@
+/*!
+
+   Memoization.c
+
+   Author: agent
+   Updated: 2026-10-19
+
+ */
+
+#include "Memoization.h"
+
+// PURITY
+
+// Returns 1 if the instructions of the function have no effect other than computing its returned value, apart
+// from the functions it calls
+static int hasPureInstructions(IntermediateFunction* function) {
+
+    if (function->isMain || function->returnValueSize > 1) return 0;
+
+    for (IntermediateInstruction* instruction = function->firstInstruction; instruction != NULL; instruction = instruction->nextInstruction) {
+        if (instruction->operation == icScan || instruction->operation == icPrint) return 0;
+    }
+
+    return 1;
+
+}
+
+void findPureFunctions(IntermediateFunction* functions) {
+
+    int changed = 1;
+
+    for (IntermediateFunction* function = functions; function != NULL; function = function->nextFunction) {
+        function->isPure = hasPureInstructions(function);
+    }
+
+    // Parameters are only known by the arguments passed to them
+    for (IntermediateFunction* function = functions; function != NULL; function = function->nextFunction) {
+        for (IntermediateInstruction* instruction = function->firstInstruction; instruction != NULL; instruction = instruction->nextInstruction) {
+            if (instruction->operation == icParameter && instruction->size != 1) getIntermediateFunction(instruction->function)->isPure = 0;
+        }
+    }
+
+    // Calling an impure function is impure, until no function changes
+    while (changed) {
+        changed = 0;
+        for (IntermediateFunction* function = functions; function != NULL; function = function->nextFunction) {
+            if (!function->isPure) continue;
+            for (IntermediateInstruction* instruction = function->firstInstruction; instruction != NULL; instruction = instruction->nextInstruction) {
+                if (instruction->operation == icFunctionCall && !getIntermediateFunction(instruction->function)->isPure) {
+                    function->isPure = 0;
+                    changed = 1;
+                    break;
+                }
+            }
+        }
+    }
+
+}
+
+
+// MEMOIZATION
+
+// Returns 1 if every call of the function passes a single argument
+static int hasSingleParameter(IntermediateFunction* functions, int index) {
+
+    for (IntermediateFunction* function = functions; function != NULL; function = function->nextFunction) {
+        for (IntermediateInstruction* call = function->firstInstruction; call != NULL; call = call->nextInstruction) {
+
+            int parameterCount = 0;
+
+            if (call->operation != icFunctionCall || call->function != index) continue;
+            for (IntermediateInstruction* parameter = call->previousInstruction; parameter != NULL && parameter->operation == icParameter && parameter->function == index; parameter = parameter->previousInstruction) parameterCount++;
+            if (parameterCount != 1) return 0;
+
+        }
+    }
+
+    return 1;
+
+}
+
+int memoizeFunctions(IntermediateFunction* functions) {
+
+    int memoizedFunctions = 0;
+
+    if (!compilerOptions.memoize || compilerOptions.memoizationTableSize <= 0) return 0;
+
+    findPureFunctions(functions);
+
+    for (IntermediateFunction* function = functions; function != NULL; function = function->nextFunction) {
+        if (!function->isPure || function->returnValueSize != 1 || function->firstParameterSize != 1) continue;
+        if (!isRecursiveFunction(function->index) || !hasSingleParameter(functions, function->index)) continue;
+
+        function->memoizedArguments = compilerOptions.memoizationTableSize;
+        function->memoizationSlot = function->activationRecordSize++;
+        memoizedFunctions++;
+    }
+
+    if (compilerOptions.showStatistics) printf("Memoization: %d pure recursive functions memoized\n", memoizedFunctions);
+
+    return memoizedFunctions;
+
+}
@@ -17,8 +17,8 @@ const int OPERATOR_PRECEDENCE[] = {
     10,
     9,
     9,
-    8,
-    7,
+    6,
+    6,
     6,
     5,
     5,
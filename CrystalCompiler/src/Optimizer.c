@@ -0,0 +1,2508 @@
+/*!
+
+   Optimizer.c
+
+   Author: agent
+   Updated: 2026-10-19
+
+ */
+
+#include "Optimizer.h"
+
+// Statistics
+static int propagatedConstants = 0;
+static int foldedExpressions = 0;
+static int foldedBranches = 0;
+static int unreachableInstructions = 0;
+static int redundantExpressions = 0;
+static int propagatedCopies = 0;
+static int deadStores = 0;
+static int hoistedInstructions = 0;
+static int rotatedLoops = 0;
+static int fullyUnrolledLoops = 0;
+static int partiallyUnrolledLoops = 0;
+static int reducedInductionVariables = 0;
+static int replacedLoopTests = 0;
+static int eliminatedBoundsChecks = 0;
+static int fusedComparisons = 0;
+static int inlinedCalls = 0;
+static int eliminatedTailCalls = 0;
+static int accumulatedCalls = 0;
+static int evaluatedCalls = 0;
+static int specializedCalls = 0;
+static int deadFunctions = 0;
+static int deadInstructions = 0;
+
+
+// INSTRUCTIONS
+
+static int isLiteralOperand(Operand operand) {
+    return operand.type == opdtInteger || operand.type == opdtChar || operand.type == opdtBoolean;
+}
+
+// Value of a 16-bit word as a signed integer
+static int getSignedWord(int word) {
+    return ((word & 0xffff) ^ 0x8000) - 0x8000;
+}
+
+// Instructions without side effects, which only compute their result
+static int isPureInstruction(IntermediateInstruction* instruction) {
+    switch (instruction->operation) {
+        case icAttribution:
+        case icArithmetic:
+        case icRelational:
+        case icLogical:
+        case icAddress:
+            return 1;
+        default:
+            return 0;
+    }
+}
+
+static int isControlInstruction(IntermediateInstruction* instruction) {
+    return instruction->operation == icLabel || instruction->operation == icJump || isConditionalJump(instruction) || instruction->operation == icReturn;
+}
+
+static int isCommutativeOperator(Operator operator) {
+    return operator == oprAdd || operator == oprMultiply || operator == oprEquals || operator == oprDifferent || operator == oprLogicAnd || operator == oprLogicOr;
+}
+
+// Makes the instruction copy the operand to its result
+static void replaceByAttribution(IntermediateInstruction* instruction, Operand operand, int value) {
+    instruction->operation = icAttribution;
+    instruction->left = operand;
+    instruction->leftValue = value;
+    instruction->rightValue = NO_VALUE;
+}
+
+// Computes the operation as the MVN does, on 16-bit words. Returns 0 if it cannot be computed at compile time.
+static int foldOperation(Operator operator, int left, int right, int* result) {
+
+    int difference = (left - right) & 0xffff;
+    int isNegative = (difference & 0x8000) != 0;
+    int isZero = difference == 0;
+
+    switch (operator) {
+
+        case oprAdd: *result = (left + right) & 0xffff; return 1;
+        case oprSubtract: *result = difference; return 1;
+        case oprMultiply: *result = (int)(((unsigned)left * (unsigned)right) & 0xffff); return 1;
+
+        // Signed division: only non-negative operands are folded
+        case oprDivide:
+            if (right == 0 || (left & 0x8000) || (right & 0x8000)) return 0;
+            *result = left / right;
+            return 1;
+
+        // Comparisons test the sign and zero of the difference, like generateRelationalComparison
+        case oprSmallerOrEqualThan: *result = isZero || isNegative; return 1;
+        case oprSmallerThan: *result = isNegative; return 1;
+        case oprBiggerThan: *result = !isZero && !isNegative; return 1;
+        case oprBiggerOrEqualThan: *result = !isNegative; return 1;
+        case oprEquals: *result = isZero; return 1;
+        case oprDifferent: *result = !isZero; return 1;
+
+        // Operands are turned into 0 or 1, then multiplied or added, like generateLogicalOperation
+        case oprLogicAnd: *result = (left != 0) * (right != 0); return 1;
+        case oprLogicOr: *result = (left != 0) + (right != 0); return 1;
+
+        default: return 0;
+
+    }
+
+}
+
+// Runs a pass over the SSA form of the function
+static void runPass(IntermediateFunction* function, void (*pass)(ControlFlowGraph*)) {
+    ControlFlowGraph* graph = buildControlFlowGraph(function);
+    buildStaticSingleAssignmentForm(graph);
+    pass(graph);
+    freeControlFlowGraph(graph);
+}
+
+
+// SPARSE CONDITIONAL CONSTANT PROPAGATION
+
+typedef enum {
+    lvTop,          // Not known yet (never defined by executed code)
+    lvConstant,
+    lvBottom        // Not constant
+} LatticeLevel;
+
+typedef struct {
+    LatticeLevel level;
+    int constant;
+} LatticeValue;
+
+static LatticeValue meetLatticeValues(LatticeValue value, LatticeValue otherValue) {
+    LatticeValue bottom = { lvBottom, 0 };
+    if (value.level == lvTop) return otherValue;
+    if (otherValue.level == lvTop) return value;
+    if (value.level == lvBottom || otherValue.level == lvBottom || value.constant != otherValue.constant) return bottom;
+    return value;
+}
+
+// Moves the value down the lattice. Returns 1 if it changed.
+static int lowerLatticeValue(LatticeValue* value, LatticeValue newValue) {
+    LatticeValue result = meetLatticeValues(*value, newValue);
+    if (result.level == value->level && result.constant == value->constant) return 0;
+    *value = result;
+    return 1;
+}
+
+static LatticeValue getOperandLatticeValue(LatticeValue* lattice, Operand operand, int value) {
+
+    LatticeValue result = { lvBottom, 0 };
+
+    if (value != NO_VALUE) return lattice[value];
+
+    // Literals which LV loads unchanged
+    if (isLiteralOperand(operand) && operand.value >= 0 && operand.value <= MAX_IMMEDIATE_VALUE) {
+        result.level = lvConstant;
+        result.constant = operand.value;
+    }
+
+    return result;
+
+}
+
+// Value of left operator right
+static LatticeValue evaluateOperation(LatticeValue* lattice, IntermediateInstruction* instruction) {
+
+    LatticeValue result = { lvBottom, 0 };
+    LatticeValue left = getOperandLatticeValue(lattice, instruction->left, instruction->leftValue);
+    LatticeValue right = getOperandLatticeValue(lattice, instruction->right, instruction->rightValue);
+
+    if (left.level == lvBottom || right.level == lvBottom) return result;
+    if (left.level == lvTop || right.level == lvTop) result.level = lvTop;
+    else if (foldOperation(instruction->operator, left.constant, right.constant, &result.constant)) result.level = lvConstant;
+
+    return result;
+
+}
+
+static LatticeValue evaluateInstruction(LatticeValue* lattice, IntermediateInstruction* instruction) {
+    LatticeValue bottom = { lvBottom, 0 };
+    if (instruction->operation == icAttribution) return getOperandLatticeValue(lattice, instruction->left, instruction->leftValue);
+    return isPureInstruction(instruction) ? evaluateOperation(lattice, instruction) : bottom;
+}
+
+// Returns 1 if the conditional jump is known to be taken, 0 if it is known not to be taken, -1 otherwise
+static int evaluateConditionalJump(LatticeValue* lattice, IntermediateInstruction* jump) {
+    LatticeValue condition = isComparisonJump(jump) ? evaluateOperation(lattice, jump) : getOperandLatticeValue(lattice, jump->left, jump->leftValue);
+    if (condition.level != lvConstant) return -1;
+    return (condition.constant != 0) == (jump->operation == icJumpIfTrue);
+}
+
+static int markEdgeExecutable(ControlFlowGraph* graph, char* executableEdges, char* executableBlocks, int block, int successorIndex) {
+    if (executableEdges[2 * block + successorIndex]) return 0;
+    executableEdges[2 * block + successorIndex] = 1;
+    executableBlocks[graph->blocks[block].successors[successorIndex]] = 1;
+    return 1;
+}
+
+static int isEdgeExecutable(ControlFlowGraph* graph, char* executableEdges, int block, int successor) {
+    for (int i = 0; i < graph->blocks[block].successorCount; i++) {
+        if (graph->blocks[block].successors[i] == successor && executableEdges[2 * block + i]) return 1;
+    }
+    return 0;
+}
+
+// Replaces an operand whose value is a constant by a literal
+static int propagateConstantOperand(LatticeValue* lattice, Operand* operand, int* value) {
+
+    Operand literal = { opdtInteger, operand->operandSymbolType, 0 };
+
+    if (*value == NO_VALUE || lattice[*value].level != lvConstant || lattice[*value].constant > MAX_IMMEDIATE_VALUE) return 0;
+
+    literal.value = lattice[*value].constant;
+    *operand = literal;
+    *value = NO_VALUE;
+
+    return 1;
+
+}
+
+static void propagateConstants(ControlFlowGraph* graph) {
+
+    LatticeValue* lattice = malloc((graph->valueCount + 1) * sizeof(LatticeValue));
+    char* executableBlocks = calloc(graph->blockCount, sizeof(char));
+    char* executableEdges = calloc(2 * graph->blockCount, sizeof(char));
+    int changed = 1;
+
+    // Values at the entry of the function are unknown, the others are optimistically assumed to be constant
+    for (int value = 0; value < graph->valueCount; value++) {
+        lattice[value].level = graph->values[value].definition == NULL && graph->values[value].phiFunction < 0 ? lvBottom : lvTop;
+        lattice[value].constant = 0;
+    }
+
+    executableBlocks[0] = 1;
+
+    while (changed) {
+
+        changed = 0;
+
+        for (int i = 0; i < graph->reachableBlockCount; i++) {
+
+            int block = graph->reversePostorder[i];
+            BasicBlock* current = &graph->blocks[block];
+            IntermediateInstruction* last = current->lastInstruction;
+
+            if (!executableBlocks[block]) continue;
+
+            // Phi functions only merge the values coming through executable edges
+            for (int j = 0; j < current->phiFunctionCount; j++) {
+                LatticeValue value = { lvTop, 0 };
+                for (int k = 0; k < current->predecessorCount; k++) {
+                    if (isEdgeExecutable(graph, executableEdges, current->predecessors[k], block)) value = meetLatticeValues(value, lattice[current->phiFunctions[j].arguments[k]]);
+                }
+                changed |= lowerLatticeValue(&lattice[current->phiFunctions[j].value], value);
+            }
+
+            for (IntermediateInstruction* instruction = current->firstInstruction; instruction != getBlockEnd(current); instruction = instruction->nextInstruction) {
+                if (instruction->resultValue != NO_VALUE) changed |= lowerLatticeValue(&lattice[instruction->resultValue], evaluateInstruction(lattice, instruction));
+            }
+
+            // A constant condition only executes one of the successors (the first one is the next block)
+            if (last != NULL && isConditionalJump(last) && current->successorCount == 2) {
+                int isTaken = evaluateConditionalJump(lattice, last);
+                if (isTaken >= 0) changed |= markEdgeExecutable(graph, executableEdges, executableBlocks, block, isTaken);
+                else {
+                    changed |= markEdgeExecutable(graph, executableEdges, executableBlocks, block, 0);
+                    changed |= markEdgeExecutable(graph, executableEdges, executableBlocks, block, 1);
+                }
+            } else {
+                for (int j = 0; j < current->successorCount; j++) changed |= markEdgeExecutable(graph, executableEdges, executableBlocks, block, j);
+            }
+
+        }
+
+    }
+
+    // Rewrite the instructions
+    for (int block = 1; block < graph->blockCount; block++) {
+
+        BasicBlock* current = &graph->blocks[block];
+        IntermediateInstruction* end = getBlockEnd(current);
+        IntermediateInstruction* nextInstruction;
+
+        for (IntermediateInstruction* instruction = current->firstInstruction; instruction != end; instruction = nextInstruction) {
+
+            nextInstruction = instruction->nextInstruction;
+
+            // Blocks never executed are removed
+            if (!executableBlocks[block]) {
+                removeIntermediateInstruction(graph->function, instruction);
+                unreachableInstructions++;
+                continue;
+            }
+
+            // Constant branches
+            if (isConditionalJump(instruction)) {
+                int isTaken = evaluateConditionalJump(lattice, instruction);
+                if (isTaken >= 0) {
+                    foldedBranches++;
+                    if (isTaken) instruction->operation = icJump;
+                    else removeIntermediateInstruction(graph->function, instruction);
+                    continue;
+                }
+            }
+
+            // Constant results
+            if (instruction->operation != icAttribution && isPureInstruction(instruction) && instruction->resultValue != NO_VALUE) {
+                LatticeValue result = lattice[instruction->resultValue];
+                if (result.level == lvConstant && result.constant <= MAX_IMMEDIATE_VALUE) {
+                    Operand literal = { opdtInteger, instruction->result.operandSymbolType, result.constant };
+                    replaceByAttribution(instruction, literal, NO_VALUE);
+                    foldedExpressions++;
+                    continue;
+                }
+            }
+
+            // Constant operands
+            if (readsLeftOperand(instruction) && getLeftOperandSize(instruction) == 1) propagatedConstants += propagateConstantOperand(lattice, &instruction->left, &instruction->leftValue);
+            if (readsRightOperand(instruction)) propagatedConstants += propagateConstantOperand(lattice, &instruction->right, &instruction->rightValue);
+
+        }
+
+    }
+
+    free(executableEdges);
+    free(executableBlocks);
+    free(lattice);
+
+}
+
+
+// GLOBAL VALUE NUMBERING
+
+// Expression computed by a dominating instruction. Operands are keyed by their value number, literals by -2 - value.
+typedef struct {
+    IntermediateOperation operation;
+    Operator operator;
+    int leftKey;
+    int rightKey;
+    int value;
+} ValueNumberEntry;
+
+// Returns 0 if the operand cannot be keyed (a variable which is not part of the SSA form)
+static int getOperandKey(int* representatives, Operand operand, int value, int* key) {
+    if (value != NO_VALUE) *key = representatives[value];
+    else if (isLiteralOperand(operand)) *key = -2 - operand.value;
+    else return 0;
+    return 1;
+}
+
+// Addresses are keyed by the slot they point to, which they do not read
+static int getInstructionKeys(int* representatives, IntermediateInstruction* instruction, int* leftKey, int* rightKey) {
+    if (instruction->operation == icAddress) {
+        *leftKey = instruction->left.value + instruction->address;
+        *rightKey = 0;
+        return 1;
+    }
+    return getOperandKey(representatives, instruction->left, instruction->leftValue, leftKey) && getOperandKey(representatives, instruction->right, instruction->rightValue, rightKey);
+}
+
+// Rewrites the use of a copy to the value it copies, if its slot still holds it
+static int propagateCopyOperand(ControlFlowGraph* graph, int* representatives, int* currentValues, Operand* operand, int* value) {
+
+    int representative;
+
+    if (*value == NO_VALUE) return 0;
+
+    representative = representatives[*value];
+    if (representative == *value || currentValues[graph->values[representative].slot] != representative) return 0;
+
+    operand->value = graph->values[representative].slot;
+    *value = representative;
+
+    return 1;
+
+}
+
+static void numberBlock(ControlFlowGraph* graph, int block, int* currentValues, int* representatives, ValueNumberEntry* table, int* tableCount) {
+
+    BasicBlock* current = &graph->blocks[block];
+    int* savedValues = malloc(graph->slotCount * sizeof(int));
+    int savedTableCount = *tableCount;
+
+    memcpy(savedValues, currentValues, graph->slotCount * sizeof(int));
+
+    for (int i = 0; i < current->phiFunctionCount; i++) currentValues[current->phiFunctions[i].slot] = current->phiFunctions[i].value;
+
+    for (IntermediateInstruction* instruction = current->firstInstruction; instruction != getBlockEnd(current); instruction = instruction->nextInstruction) {
+
+        int leftKey;
+        int rightKey;
+
+        if (readsLeftOperand(instruction)) propagatedCopies += propagateCopyOperand(graph, representatives, currentValues, &instruction->left, &instruction->leftValue);
+        if (readsRightOperand(instruction)) propagatedCopies += propagateCopyOperand(graph, representatives, currentValues, &instruction->right, &instruction->rightValue);
+
+        if (instruction->resultValue == NO_VALUE) continue;
+
+        // Copies share the value number of their source
+        if (instruction->operation == icAttribution && instruction->leftValue != NO_VALUE) representatives[instruction->resultValue] = representatives[instruction->leftValue];
+
+        // Expressions already computed by a dominating instruction
+        else if (instruction->operation != icAttribution && isPureInstruction(instruction) && getInstructionKeys(representatives, instruction, &leftKey, &rightKey)) {
+
+            int i;
+
+            if (isCommutativeOperator(instruction->operator) && leftKey > rightKey) {
+                int key = leftKey;
+                leftKey = rightKey;
+                rightKey = key;
+            }
+
+            for (i = *tableCount - 1; i >= 0; i--) {
+                if (table[i].operation == instruction->operation && table[i].operator == instruction->operator && table[i].leftKey == leftKey && table[i].rightKey == rightKey) break;
+            }
+
+            if (i >= 0 && currentValues[graph->values[table[i].value].slot] == table[i].value) {
+                Operand copy = { opdtTemporary, instruction->result.operandSymbolType, graph->values[table[i].value].slot };
+                replaceByAttribution(instruction, copy, table[i].value);
+                representatives[instruction->resultValue] = table[i].value;
+                redundantExpressions++;
+            }
+
+            // Otherwise this computation is the one found by the dominated instructions
+            else {
+                table[*tableCount].operation = instruction->operation;
+                table[*tableCount].operator = instruction->operator;
+                table[*tableCount].leftKey = leftKey;
+                table[*tableCount].rightKey = rightKey;
+                table[*tableCount].value = instruction->resultValue;
+                (*tableCount)++;
+            }
+
+        }
+
+        currentValues[graph->values[instruction->resultValue].slot] = instruction->resultValue;
+
+    }
+
+    // Children in the dominator tree
+    for (int i = 1; i < graph->reachableBlockCount; i++) {
+        int child = graph->reversePostorder[i];
+        if (graph->blocks[child].immediateDominator == block) numberBlock(graph, child, currentValues, representatives, table, tableCount);
+    }
+
+    // Expressions computed in this block are not available to the other blocks
+    *tableCount = savedTableCount;
+    memcpy(currentValues, savedValues, graph->slotCount * sizeof(int));
+    free(savedValues);
+
+}
+
+static void numberValues(ControlFlowGraph* graph) {
+
+    int* currentValues = malloc((graph->slotCount + 1) * sizeof(int));
+    int* representatives = malloc((graph->valueCount + 1) * sizeof(int));
+    ValueNumberEntry* table = malloc((graph->valueCount + 1) * sizeof(ValueNumberEntry));
+    int tableCount = 0;
+
+    for (int value = 0; value < graph->valueCount; value++) representatives[value] = value;
+
+    // Entry values are the ones without definition in the entry block
+    for (int slot = 0; slot < graph->slotCount; slot++) currentValues[slot] = NO_VALUE;
+    for (int value = 0; value < graph->valueCount; value++) {
+        if (graph->values[value].block == 0) currentValues[graph->values[value].slot] = value;
+    }
+
+    numberBlock(graph, 0, currentValues, representatives, table, &tableCount);
+
+    free(table);
+    free(representatives);
+    free(currentValues);
+
+}
+
+
+// DEAD STORE ELIMINATION
+
+static void markLiveValue(char* liveValues, int* worklist, int* worklistCount, int value) {
+    if (value == NO_VALUE || liveValues[value]) return;
+    liveValues[value] = 1;
+    worklist[(*worklistCount)++] = value;
+}
+
+static void eliminateDeadStores(ControlFlowGraph* graph) {
+
+    char* liveValues = calloc(graph->valueCount + 1, sizeof(char));
+    int* worklist = malloc((graph->valueCount + 1) * sizeof(int));
+    int worklistCount = 0;
+
+    // Values used by instructions which are always kept
+    for (int block = 1; block < graph->blockCount; block++) {
+        for (IntermediateInstruction* instruction = graph->blocks[block].firstInstruction; instruction != getBlockEnd(&graph->blocks[block]); instruction = instruction->nextInstruction) {
+            if (isPureInstruction(instruction) && instruction->resultValue != NO_VALUE) continue;
+            markLiveValue(liveValues, worklist, &worklistCount, instruction->leftValue);
+            markLiveValue(liveValues, worklist, &worklistCount, instruction->rightValue);
+        }
+    }
+
+    // Values used to compute live values
+    while (worklistCount > 0) {
+        SSAValue* value = &graph->values[worklist[--worklistCount]];
+        if (value->definition != NULL) {
+            markLiveValue(liveValues, worklist, &worklistCount, value->definition->leftValue);
+            markLiveValue(liveValues, worklist, &worklistCount, value->definition->rightValue);
+        } else if (value->phiFunction >= 0) {
+            BasicBlock* block = &graph->blocks[value->block];
+            for (int i = 0; i < block->predecessorCount; i++) markLiveValue(liveValues, worklist, &worklistCount, block->phiFunctions[value->phiFunction].arguments[i]);
+        }
+    }
+
+    for (int block = 1; block < graph->blockCount; block++) {
+        IntermediateInstruction* end = getBlockEnd(&graph->blocks[block]);
+        IntermediateInstruction* nextInstruction;
+        for (IntermediateInstruction* instruction = graph->blocks[block].firstInstruction; instruction != end; instruction = nextInstruction) {
+            nextInstruction = instruction->nextInstruction;
+            if (isPureInstruction(instruction) && instruction->resultValue != NO_VALUE && !liveValues[instruction->resultValue]) {
+                removeIntermediateInstruction(graph->function, instruction);
+                deadStores++;
+            }
+        }
+    }
+
+    free(worklist);
+    free(liveValues);
+
+}
+
+
+// LOOP-INVARIANT CODE MOTION
+
+// Operand with the same value in every iteration of the loop: a literal, a value computed before the loop or a
+// value computed by an instruction already hoisted
+static int isInvariantOperand(ControlFlowGraph* graph, char* isLoopBlock, char* hoistedValues, Operand operand, int value) {
+    if (value == NO_VALUE) return isLiteralOperand(operand);
+    return !isLoopBlock[graph->values[value].block] || hoistedValues[value];
+}
+
+// The instruction may run even when the loop body does not, so it must not be able to stop the program
+static int isInvariantInstruction(ControlFlowGraph* graph, char* isLoopBlock, char* hoistedValues, IntermediateInstruction* instruction) {
+    if (!isPureInstruction(instruction) || instruction->resultValue == NO_VALUE) return 0;
+    if (instruction->operation == icAddress) return 1;
+    if (instruction->operation == icArithmetic && instruction->operator == oprDivide && (!isLiteralOperand(instruction->right) || instruction->right.value == 0)) return 0;
+    if (!isInvariantOperand(graph, isLoopBlock, hoistedValues, instruction->left, instruction->leftValue)) return 0;
+    return !readsRightOperand(instruction) || isInvariantOperand(graph, isLoopBlock, hoistedValues, instruction->right, instruction->rightValue);
+}
+
+// The slot of a hoisted instruction holds its value during the whole loop and after it, so the slot must not be
+// written by other instructions of the loop, every use in the loop must read this value and no value of the
+// slot coming from the loop may be used after it
+static int canHoistResult(ControlFlowGraph* graph, char* isLoopBlock, char* usedOutsideLoop, IntermediateInstruction* hoisted) {
+
+    int slot = graph->values[hoisted->resultValue].slot;
+
+    for (int block = 1; block < graph->blockCount; block++) {
+        if (!isLoopBlock[block]) continue;
+        for (IntermediateInstruction* instruction = graph->blocks[block].firstInstruction; instruction != getBlockEnd(&graph->blocks[block]); instruction = instruction->nextInstruction) {
+            if (instruction != hoisted && instruction->resultValue != NO_VALUE && graph->values[instruction->resultValue].slot == slot) return 0;
+            if (instruction->leftValue != NO_VALUE && graph->values[instruction->leftValue].slot == slot && instruction->leftValue != hoisted->resultValue) return 0;
+            if (instruction->rightValue != NO_VALUE && graph->values[instruction->rightValue].slot == slot && instruction->rightValue != hoisted->resultValue) return 0;
+        }
+    }
+
+    for (int value = 0; value < graph->valueCount; value++) {
+        if (graph->values[value].slot == slot && isLoopBlock[graph->values[value].block] && usedOutsideLoop[value]) return 0;
+    }
+
+    return 1;
+
+}
+
+// Phi functions whose value is read by an instruction, directly or through other phi functions
+static void markUsedPhiFunctions(ControlFlowGraph* graph, char* usedPhiValues) {
+
+    int* worklist = malloc((graph->valueCount + 1) * sizeof(int));
+    int worklistCount = 0;
+
+    for (int block = 1; block < graph->blockCount; block++) {
+        for (IntermediateInstruction* instruction = graph->blocks[block].firstInstruction; instruction != getBlockEnd(&graph->blocks[block]); instruction = instruction->nextInstruction) {
+            int uses[2] = { instruction->leftValue, instruction->rightValue };
+            for (int i = 0; i < 2; i++) {
+                if (uses[i] != NO_VALUE && graph->values[uses[i]].phiFunction >= 0 && !usedPhiValues[uses[i]]) {
+                    usedPhiValues[uses[i]] = 1;
+                    worklist[worklistCount++] = uses[i];
+                }
+            }
+        }
+    }
+
+    while (worklistCount > 0) {
+        SSAValue* value = &graph->values[worklist[--worklistCount]];
+        BasicBlock* block = &graph->blocks[value->block];
+        for (int i = 0; i < block->predecessorCount; i++) {
+            int argument = block->phiFunctions[value->phiFunction].arguments[i];
+            if (graph->values[argument].phiFunction >= 0 && !usedPhiValues[argument]) {
+                usedPhiValues[argument] = 1;
+                worklist[worklistCount++] = argument;
+            }
+        }
+    }
+
+    free(worklist);
+
+}
+
+// Returns 1 if the value is merged by a phi function which is read
+static int flowsIntoUsedPhiFunction(ControlFlowGraph* graph, char* usedPhiValues, int value) {
+    for (int phiValue = 0; phiValue < graph->valueCount; phiValue++) {
+        SSAValue* phi = &graph->values[phiValue];
+        if (phi->phiFunction < 0 || !usedPhiValues[phiValue]) continue;
+        for (int i = 0; i < graph->blocks[phi->block].predecessorCount; i++) {
+            if (graph->blocks[phi->block].phiFunctions[phi->phiFunction].arguments[i] == value) return 1;
+        }
+    }
+    return 0;
+}
+
+// Moves the result of the instruction to a new slot of the activation record, updating the instructions reading it
+static void renameResult(ControlFlowGraph* graph, IntermediateInstruction* instruction) {
+
+    int slot = graph->function->activationRecordSize++;
+
+    instruction->result.value = slot;
+    graph->values[instruction->resultValue].slot = slot;
+
+    for (IntermediateInstruction* reader = graph->function->firstInstruction; reader != NULL; reader = reader->nextInstruction) {
+        if (reader->leftValue == instruction->resultValue) reader->left.value = slot;
+        if (reader->rightValue == instruction->resultValue) reader->right.value = slot;
+    }
+
+}
+
+static void markUsedOutsideLoop(ControlFlowGraph* graph, char* isLoopBlock, char* usedOutsideLoop) {
+    for (int block = 1; block < graph->blockCount; block++) {
+        BasicBlock* current = &graph->blocks[block];
+        if (isLoopBlock[block]) continue;
+        for (int i = 0; i < current->phiFunctionCount; i++) {
+            for (int j = 0; j < current->predecessorCount; j++) usedOutsideLoop[current->phiFunctions[i].arguments[j]] = 1;
+        }
+        for (IntermediateInstruction* instruction = current->firstInstruction; instruction != getBlockEnd(current); instruction = instruction->nextInstruction) {
+            if (instruction->leftValue != NO_VALUE) usedOutsideLoop[instruction->leftValue] = 1;
+            if (instruction->rightValue != NO_VALUE) usedOutsideLoop[instruction->rightValue] = 1;
+        }
+    }
+}
+
+// Hoists the invariant instructions of the loop to a preheader: the end of the block falling into the header,
+// in front of its label. Returns 0 if the loop has no such block.
+static int hoistLoopInvariants(ControlFlowGraph* graph, int header) {
+
+    BasicBlock* headerBlock = &graph->blocks[header];
+    IntermediateInstruction* preheaderEnd = graph->blocks[header - 1].lastInstruction;
+    char* isLoopBlock = malloc(graph->blockCount);
+    char* hoistedValues;
+    char* usedOutsideLoop;
+    char* usedPhiValues;
+
+    findNaturalLoop(graph, header, isLoopBlock);
+
+    // The loop must only be entered from the previous block
+    if (preheaderEnd != NULL && (preheaderEnd->operation == icJump || preheaderEnd->operation == icReturn)) {
+        free(isLoopBlock);
+        return 0;
+    }
+    for (int i = 0; i < headerBlock->predecessorCount; i++) {
+        if (!isLoopBlock[headerBlock->predecessors[i]] && headerBlock->predecessors[i] != header - 1) {
+            free(isLoopBlock);
+            return 0;
+        }
+    }
+
+    hoistedValues = calloc(graph->valueCount + 1, sizeof(char));
+    usedOutsideLoop = calloc(graph->valueCount + 1, sizeof(char));
+    usedPhiValues = calloc(graph->valueCount + 1, sizeof(char));
+    markUsedOutsideLoop(graph, isLoopBlock, usedOutsideLoop);
+    markUsedPhiFunctions(graph, usedPhiValues);
+
+    // Blocks in program order, so the instructions using hoisted values are found after them
+    for (int block = header; block < graph->blockCount; block++) {
+
+        IntermediateInstruction* end = getBlockEnd(&graph->blocks[block]);
+        IntermediateInstruction* nextInstruction;
+
+        if (!isLoopBlock[block]) continue;
+
+        for (IntermediateInstruction* instruction = graph->blocks[block].firstInstruction; instruction != end; instruction = nextInstruction) {
+            nextInstruction = instruction->nextInstruction;
+            if (!isInvariantInstruction(graph, isLoopBlock, hoistedValues, instruction)) continue;
+
+            // A slot shared with other values (usually a temporary variable) is replaced by a new one, as long as
+            // its value only reaches the instructions reading it directly
+            if (!canHoistResult(graph, isLoopBlock, usedOutsideLoop, instruction)) {
+                if (flowsIntoUsedPhiFunction(graph, usedPhiValues, instruction->resultValue)) continue;
+                renameResult(graph, instruction);
+            }
+
+            // The block of the instruction stays valid for the next checks
+            if (instruction == graph->blocks[block].firstInstruction && instruction == graph->blocks[block].lastInstruction) graph->blocks[block].firstInstruction = graph->blocks[block].lastInstruction = NULL;
+            else if (instruction == graph->blocks[block].firstInstruction) graph->blocks[block].firstInstruction = nextInstruction;
+            else if (instruction == graph->blocks[block].lastInstruction) graph->blocks[block].lastInstruction = instruction->previousInstruction;
+
+            moveIntermediateInstruction(graph->function, instruction, headerBlock->firstInstruction);
+            hoistedValues[instruction->resultValue] = 1;
+            hoistedInstructions++;
+
+        }
+
+    }
+
+    free(usedPhiValues);
+    free(usedOutsideLoop);
+    free(hoistedValues);
+    free(isLoopBlock);
+
+    return 1;
+
+}
+
+// Loops are processed from the last header, so inner loops are hoisted before the loops containing them
+static void hoistFunctionLoopInvariants(IntermediateFunction* function) {
+
+    char* processedLabels = calloc(function->labelCounter + 1, sizeof(char));
+    int header;
+
+    do {
+
+        ControlFlowGraph* graph = buildControlFlowGraph(function);
+        buildStaticSingleAssignmentForm(graph);
+
+        for (header = graph->blockCount - 1; header > 0; header--) {
+            IntermediateInstruction* label = graph->blocks[header].firstInstruction;
+            if (isLoopHeader(graph, header) && !processedLabels[label->label]) break;
+        }
+
+        if (header > 0) {
+            processedLabels[graph->blocks[header].firstInstruction->label] = 1;
+            hoistLoopInvariants(graph, header);
+        }
+
+        freeControlFlowGraph(graph);
+
+    } while (header > 0);
+
+    free(processedLabels);
+
+}
+
+
+// LOOP ROTATION
+
+// Returns the number of jumps to the label
+static int countJumpsTo(IntermediateFunction* function, int label) {
+    int count = 0;
+    for (IntermediateInstruction* instruction = function->firstInstruction; instruction != NULL; instruction = instruction->nextInstruction) {
+        if ((instruction->operation == icJump || isConditionalJump(instruction)) && instruction->label == label) count++;
+    }
+    return count;
+}
+
+static IntermediateInstruction* findLabel(IntermediateFunction* function, int label) {
+    IntermediateInstruction* instruction;
+    for (instruction = function->firstInstruction; instruction != NULL && !(instruction->operation == icLabel && instruction->label == label); instruction = instruction->nextInstruction);
+    return instruction;
+}
+
+// A while loop (label, test, jump if false to the end, body, jump back) becomes a guarded do-while loop: the test
+// is copied in front of the label, and the one at the top moves to the bottom and jumps back if true. The labels
+// are kept, so only the jump back is saved. Only loops whose test will be fused with its comparison are rotated.
+static void rotateLoops(IntermediateFunction* function) {
+
+    for (IntermediateInstruction* header = function->firstInstruction; header != NULL; header = header->nextInstruction) {
+
+        IntermediateInstruction* test;
+        IntermediateInstruction* endLabel;
+        IntermediateInstruction* backJump;
+        IntermediateInstruction* condition;
+        IntermediateInstruction* guard;
+
+        if (header->operation != icLabel) continue;
+
+        for (test = header->nextInstruction; test != NULL && !isControlInstruction(test); test = test->nextInstruction);
+        if (test == NULL || test->operation != icJumpIfFalse) continue;
+
+        endLabel = findLabel(function, test->label);
+        if (endLabel == NULL) continue;
+        backJump = endLabel->previousInstruction;
+        if (backJump->operation != icJump || backJump->label != header->label || countJumpsTo(function, header->label) != 1) continue;
+
+        // The test must compare, or be computed by a comparison just before it. Jumping back if the operands are
+        // different takes more than the jump saved.
+        if (!isComparisonJump(test)) {
+            IntermediateInstruction* comparison = test->previousInstruction;
+            if (comparison == header || comparison->operation != icRelational || comparison->result.value != test->left.value || comparison->operator == oprDifferent) continue;
+        } else if (test->operator == oprDifferent) continue;
+
+        // Entry test
+        for (condition = header->nextInstruction; condition != test; condition = condition->nextInstruction) copyIntermediateInstruction(function, condition, header);
+        guard = copyIntermediateInstruction(function, test, header);
+        guard->comment = "While Guard";
+
+        // Bottom test
+        while (header->nextInstruction != test) moveIntermediateInstruction(function, header->nextInstruction, backJump);
+        moveIntermediateInstruction(function, test, backJump);
+        test->operation = icJumpIfTrue;
+        test->label = header->label;
+        removeIntermediateInstruction(function, backJump);
+
+        rotatedLoops++;
+
+    }
+
+}
+
+
+// LOOP UNROLLING
+
+// Largest number of iterations simulated to find the trip count of a loop
+#define MAX_TRIP_COUNT 0x10000
+
+// Largest label of a function after unrolling, so the labels of the code generator still fit in two digits
+#define MAX_UNROLLED_LABEL 0x80
+
+// Returns the step (induction variable plus or minus a literal) whose result is the value, or that value copied
+static IntermediateInstruction* findInductionStep(ControlFlowGraph* graph, int header, int value) {
+
+    IntermediateInstruction* step;
+
+    if (value == NO_VALUE || graph->values[value].definition == NULL) return NULL;
+    step = graph->values[value].definition;
+    if (step->operation == icAttribution && step->leftValue != NO_VALUE) step = graph->values[step->leftValue].definition;
+
+    if (step == NULL || step->operation != icArithmetic || (step->operator != oprAdd && step->operator != oprSubtract)) return NULL;
+    if (!isLiteralOperand(step->right) || step->leftValue == NO_VALUE) return NULL;
+
+    // The induction variable is merged at the header
+    if (graph->values[step->leftValue].phiFunction < 0 || graph->values[step->leftValue].block != header) return NULL;
+
+    return step;
+
+}
+
+// Values taken at the header by the induction variable of a loop with a known trip count (signed words)
+typedef struct {
+    int inductionVariable;
+    int minimum;
+    int maximum;
+} InductionRange;
+
+// Returns the number of iterations of the loop whose header is given and whose bottom test jumps back to it,
+// or 0 if it is not known at compile time. The induction variable must start with a literal, change by a literal
+// once per iteration and be compared with a literal by the test. Its values are placed in range, if given.
+static int findTripCount(ControlFlowGraph* graph, int header, IntermediateInstruction* test, InductionRange* range) {
+
+    IntermediateInstruction* comparison = test;
+    IntermediateInstruction* step;
+    PhiFunction* inductionVariable;
+    BasicBlock* headerBlock = &graph->blocks[header];
+    int isInductionVariableLeft;
+    int initialValue = -1;
+    int bound;
+    int value;
+    int condition;
+    int tripCount = 0;
+
+    if (!isComparisonJump(test)) {
+        comparison = test->previousInstruction;
+        if (comparison->operation != icRelational || comparison->resultValue == NO_VALUE || comparison->resultValue != test->leftValue) return 0;
+    }
+
+    isInductionVariableLeft = isLiteralOperand(comparison->right);
+    if (isInductionVariableLeft) {
+        step = findInductionStep(graph, header, comparison->leftValue);
+        bound = comparison->right.value & 0xffff;
+    } else {
+        if (!isLiteralOperand(comparison->left)) return 0;
+        step = findInductionStep(graph, header, comparison->rightValue);
+        bound = comparison->left.value & 0xffff;
+    }
+    if (step == NULL || headerBlock->predecessorCount != 2) return 0;
+
+    // The value coming from the loop is the step, the one coming from outside it is a literal
+    inductionVariable = &headerBlock->phiFunctions[graph->values[step->leftValue].phiFunction];
+    for (int i = 0; i < 2; i++) {
+        int argument = inductionVariable->arguments[i];
+        IntermediateInstruction* definition = graph->values[argument].definition;
+        if (dominates(graph, header, headerBlock->predecessors[i])) {
+            if (findInductionStep(graph, header, argument) != step) return 0;
+        } else {
+            if (definition == NULL || definition->operation != icAttribution || !isLiteralOperand(definition->left)) return 0;
+            initialValue = definition->left.value & 0xffff;
+        }
+    }
+    if (initialValue < 0) return 0;
+
+    // The body runs once before the first test
+    value = initialValue;
+    if (range != NULL) {
+        range->inductionVariable = step->leftValue;
+        range->minimum = range->maximum = getSignedWord(value);
+    }
+    do {
+        if (range != NULL && getSignedWord(value) < range->minimum) range->minimum = getSignedWord(value);
+        if (range != NULL && getSignedWord(value) > range->maximum) range->maximum = getSignedWord(value);
+        foldOperation(step->operator, value, step->right.value & 0xffff, &value);
+        if (isInductionVariableLeft) foldOperation(comparison->operator, value, bound, &condition);
+        else foldOperation(comparison->operator, bound, value, &condition);
+        tripCount++;
+    } while (condition && tripCount < MAX_TRIP_COUNT);
+
+    return condition ? 0 : tripCount;
+
+}
+
+// Copies the instructions from first to the one before end in front of nextInstruction. The labels they define
+// are replaced by new ones.
+static void copyLoopIteration(IntermediateFunction* function, IntermediateInstruction* first, IntermediateInstruction* end, IntermediateInstruction* nextInstruction) {
+
+    int labelCount = function->labelCounter;
+    int* newLabels = malloc((labelCount + 1) * sizeof(int));
+
+    for (int label = 0; label < labelCount; label++) newLabels[label] = -1;
+    for (IntermediateInstruction* instruction = first; instruction != end; instruction = instruction->nextInstruction) {
+        if (instruction->operation == icLabel) newLabels[instruction->label] = newIntermediateLabel(function);
+    }
+
+    for (IntermediateInstruction* instruction = first; instruction != end; instruction = instruction->nextInstruction) {
+        IntermediateInstruction* copy = copyIntermediateInstruction(function, instruction, nextInstruction);
+        if ((copy->operation == icLabel || copy->operation == icJump || isConditionalJump(copy)) && copy->label < labelCount && newLabels[copy->label] >= 0) copy->label = newLabels[copy->label];
+    }
+
+    free(newLabels);
+
+}
+
+// Returns the bottom test of the loop of the header if it is a guarded do-while loop (see rotateLoops and
+// appendEndFor): a jump if true back to its label, which is the only jump to it, with the blocks of the loop in
+// between. Returns NULL otherwise. The blocks of the loop are marked in isLoopBlock.
+static IntermediateInstruction* findBottomTest(ControlFlowGraph* graph, int header, char* isLoopBlock) {
+
+    IntermediateInstruction* label = graph->blocks[header].firstInstruction;
+    IntermediateInstruction* test;
+    int latch = -1;
+
+    for (test = label->nextInstruction; test != NULL && !(test->operation == icJumpIfTrue && test->label == label->label); test = test->nextInstruction);
+    if (test == NULL || countJumpsTo(graph->function, label->label) != 1) return NULL;
+
+    findNaturalLoop(graph, header, isLoopBlock);
+    for (int block = 1; block < graph->blockCount; block++) {
+        if (graph->blocks[block].lastInstruction == test) latch = block;
+    }
+    for (int block = 1; block < graph->blockCount; block++) {
+        if (isLoopBlock[block] && (block < header || block > latch)) latch = -1;
+    }
+
+    return latch < 0 ? NULL : test;
+
+}
+
+// Unrolls the loop of the header if it is a guarded do-while loop with a known trip count. Small loops are replaced by a copy of the body for each iteration. Larger ones run the remaining
+// iterations (trip count modulo the unroll factor) in front of the loop, whose body is then repeated unroll
+// factor times, so the test only runs after the last copy. Returns 1 if the loop was unrolled.
+static int unrollLoop(ControlFlowGraph* graph, int header) {
+
+    IntermediateFunction* function = graph->function;
+    IntermediateInstruction* label = graph->blocks[header].firstInstruction;
+    IntermediateInstruction* body = label->nextInstruction;
+    IntermediateInstruction* test;
+    char* isLoopBlock = malloc(graph->blockCount);
+    int size = 0;
+    int labelCount = 0;
+    int tripCount;
+    int factor = compilerOptions.unrollFactor;
+
+    test = findBottomTest(graph, header, isLoopBlock);
+    free(isLoopBlock);
+    if (test == NULL) return 0;
+
+    for (IntermediateInstruction* instruction = body; instruction != test; instruction = instruction->nextInstruction) {
+        size++;
+        if (instruction->operation == icLabel) labelCount++;
+    }
+
+    tripCount = findTripCount(graph, header, test, NULL);
+    if (tripCount == 0) return 0;
+
+    // Full unrolling: the last iteration is the loop body itself
+    if (tripCount * size <= compilerOptions.unrollLimit && function->labelCounter + (tripCount - 1) * labelCount <= MAX_UNROLLED_LABEL) {
+        for (int i = 1; i < tripCount; i++) copyLoopIteration(function, body, test, label);
+        removeIntermediateInstruction(function, label);
+        removeIntermediateInstruction(function, test);
+        fullyUnrolledLoops++;
+        return 1;
+    }
+
+    // Partial unrolling
+    if (factor < 2 || factor * size > compilerOptions.unrollLimit || function->labelCounter + (factor - 1 + tripCount % factor) * labelCount > MAX_UNROLLED_LABEL) return 0;
+    for (int i = 0; i < tripCount % factor; i++) copyLoopIteration(function, body, test, label);
+    for (int i = 1; i < factor; i++) copyLoopIteration(function, body, test, body);
+    partiallyUnrolledLoops++;
+
+    return 1;
+
+}
+
+// Loops are unrolled from the last header, so inner loops are unrolled before the loops containing them. The
+// loops copied by the unrolling of an outer loop are not unrolled again.
+static int unrollLoops(IntermediateFunction* function) {
+
+    int labelCount = function->labelCounter;
+    char* processedLabels = calloc(labelCount + 1, sizeof(char));
+    int unrolledLoops = 0;
+    int header;
+
+    do {
+
+        ControlFlowGraph* graph = buildControlFlowGraph(function);
+        buildStaticSingleAssignmentForm(graph);
+
+        for (header = graph->blockCount - 1; header > 0; header--) {
+            IntermediateInstruction* label = graph->blocks[header].firstInstruction;
+            if (isLoopHeader(graph, header) && label->label < labelCount && !processedLabels[label->label]) break;
+        }
+
+        if (header > 0) {
+            processedLabels[graph->blocks[header].firstInstruction->label] = 1;
+            unrolledLoops += unrollLoop(graph, header);
+        }
+
+        freeControlFlowGraph(graph);
+
+    } while (header > 0);
+
+    free(processedLabels);
+
+    return unrolledLoops;
+
+}
+
+
+// INDUCTION VARIABLE STRENGTH REDUCTION
+
+// Value computed as base + induction variable * multiplier (usually the address of an array element), kept up to
+// date in a slot of its own which is increased by multiplier * step in every iteration
+typedef struct {
+    int multiplier;
+    Operand base;
+    int baseValue;
+    int slot;
+} ReducedInductionVariable;
+
+// Finds the offset of the value from the induction variable (the value of a phi function of the header), following
+// the copies and the additions or subtractions of literals. Returns 0 if the value is not derived from it this way.
+static int getInductionOffset(ControlFlowGraph* graph, int inductionVariable, int value, int* offset) {
+
+    *offset = 0;
+
+    while (value != inductionVariable) {
+
+        IntermediateInstruction* definition;
+
+        if (value == NO_VALUE || graph->values[value].definition == NULL) return 0;
+        definition = graph->values[value].definition;
+
+        if (definition->operation == icAttribution) value = definition->leftValue;
+        else if (definition->operation == icArithmetic && (definition->operator == oprAdd || definition->operator == oprSubtract) && isLiteralOperand(definition->right)) {
+            *offset += definition->operator == oprAdd ? definition->right.value : -definition->right.value;
+            value = definition->leftValue;
+        }
+        else return 0;
+
+    }
+
+    return 1;
+
+}
+
+// Returns the multiplier of an instruction computing a value derived from the induction variable times a literal,
+// and the offset of that value, or 0 if it is not such a multiplication
+static int getInductionMultiplier(ControlFlowGraph* graph, int inductionVariable, IntermediateInstruction* instruction, int* offset) {
+
+    if (instruction == NULL || instruction->operation != icArithmetic || instruction->operator != oprMultiply) return 0;
+
+    if (isLiteralOperand(instruction->right) && getInductionOffset(graph, inductionVariable, instruction->leftValue, offset)) return instruction->right.value;
+    if (isLiteralOperand(instruction->left) && getInductionOffset(graph, inductionVariable, instruction->rightValue, offset)) return instruction->left.value;
+
+    return 0;
+
+}
+
+// Makes the instruction compute operand plus the amount (minus its opposite if it is negative). The amount must fit
+// in a literal.
+static void setAddition(IntermediateInstruction* instruction, Operand operand, int amount) {
+
+    Operand literal = { opdtInteger, stInt, amount < 0 ? -amount : amount };
+
+    if (amount == 0) {
+        replaceByAttribution(instruction, operand, NO_VALUE);
+        return;
+    }
+
+    instruction->operation = icArithmetic;
+    instruction->operator = amount < 0 ? oprSubtract : oprAdd;
+    instruction->left = operand;
+    instruction->right = literal;
+    instruction->leftValue = NO_VALUE;
+    instruction->rightValue = NO_VALUE;
+
+}
+
+static int fitsInLiteral(int amount) {
+    return amount >= -MAX_IMMEDIATE_VALUE && amount <= MAX_IMMEDIATE_VALUE;
+}
+
+// Inserts an instruction computing slot = operand plus the amount before nextInstruction
+static void insertAddition(IntermediateFunction* function, int slot, Operand operand, int amount, IntermediateInstruction* nextInstruction) {
+    IntermediateInstruction* instruction = insertIntermediateInstruction(function, icArithmetic, nextInstruction);
+    Operand result = { opdtTemporary, stInt, slot };
+    instruction->result = result;
+    instruction->resultValue = NO_VALUE;
+    setAddition(instruction, operand, amount);
+}
+
+// Initializes the slot of the reduced value in the preheader (in front of the label): base + initial value of the
+// induction variable * multiplier, computed at compile time if the induction variable starts with a literal
+static void initializeReducedInductionVariable(ControlFlowGraph* graph, int inductionVariable, int entryValue, ReducedInductionVariable* reduced, IntermediateInstruction* label) {
+
+    IntermediateInstruction* definition = graph->values[entryValue].definition;
+    IntermediateInstruction* product;
+    IntermediateInstruction* sum;
+    Operand slot = { opdtTemporary, stInt, reduced->slot };
+    Operand variable = { opdtVariable, stInt, graph->values[inductionVariable].slot };
+    Operand multiplier = { opdtInteger, stInt, reduced->multiplier };
+
+    if (definition != NULL && definition->operation == icAttribution && isLiteralOperand(definition->left)) {
+        int initialValue = (int)(((unsigned)definition->left.value * (unsigned)reduced->multiplier) & 0xffff);
+        if (isLiteralOperand(reduced->base)) {
+            Operand literal = { opdtInteger, stInt, (reduced->base.value + initialValue) & 0xffff };
+            if (literal.value <= MAX_IMMEDIATE_VALUE) {
+                insertAddition(graph->function, reduced->slot, literal, 0, label);
+                return;
+            }
+        } else if (initialValue <= MAX_IMMEDIATE_VALUE) {
+            insertAddition(graph->function, reduced->slot, reduced->base, initialValue, label);
+            return;
+        }
+    }
+
+    product = insertIntermediateInstruction(graph->function, icArithmetic, label);
+    product->operator = oprMultiply;
+    product->result = slot;
+    product->left = variable;
+    product->right = multiplier;
+    product->resultValue = product->leftValue = product->rightValue = NO_VALUE;
+
+    sum = insertIntermediateInstruction(graph->function, icArithmetic, label);
+    sum->operator = oprAdd;
+    sum->result = slot;
+    sum->left = slot;
+    sum->right = reduced->base;
+    sum->resultValue = sum->leftValue = sum->rightValue = NO_VALUE;
+
+}
+
+// Returns 1 if the values derived from the induction variable are only read by the instructions computing them, by
+// the comparison of the bottom test and by instructions whose results are never used
+static int isInductionVariableOtherwiseDead(ControlFlowGraph* graph, int inductionVariable, IntermediateInstruction* comparison) {
+
+    char* isDerived = calloc(graph->valueCount + 1, sizeof(char));
+    char* usedPhiValues = calloc(graph->valueCount + 1, sizeof(char));
+    int* useCounts = calloc(graph->valueCount + 1, sizeof(int));
+    int isDead = 1;
+    int offset;
+
+    for (int value = 0; value < graph->valueCount; value++) isDerived[value] = getInductionOffset(graph, inductionVariable, value, &offset);
+
+    // Uses by instructions, and by phi functions whose value is read
+    markUsedPhiFunctions(graph, usedPhiValues);
+    for (int block = 1; block < graph->blockCount && isDead; block++) {
+        BasicBlock* current = &graph->blocks[block];
+        for (int i = 0; i < current->phiFunctionCount; i++) {
+            if (!usedPhiValues[current->phiFunctions[i].value]) continue;
+            for (int j = 0; j < current->predecessorCount; j++) {
+                int argument = current->phiFunctions[i].arguments[j];
+                useCounts[argument]++;
+                if (isDerived[argument] && current->phiFunctions[i].value != inductionVariable) isDead = 0;
+            }
+        }
+        for (IntermediateInstruction* instruction = current->firstInstruction; instruction != getBlockEnd(current); instruction = instruction->nextInstruction) {
+            if (instruction->leftValue != NO_VALUE) useCounts[instruction->leftValue]++;
+            if (instruction->rightValue != NO_VALUE) useCounts[instruction->rightValue]++;
+        }
+    }
+
+    for (int block = 1; block < graph->blockCount && isDead; block++) {
+        for (IntermediateInstruction* instruction = graph->blocks[block].firstInstruction; instruction != getBlockEnd(&graph->blocks[block]); instruction = instruction->nextInstruction) {
+            int readsDerivedValue = (instruction->leftValue != NO_VALUE && isDerived[instruction->leftValue]) || (instruction->rightValue != NO_VALUE && isDerived[instruction->rightValue]);
+            if (!readsDerivedValue || instruction == comparison) continue;
+            if (instruction->resultValue != NO_VALUE && (isDerived[instruction->resultValue] || (isPureInstruction(instruction) && useCounts[instruction->resultValue] == 0))) continue;
+            isDead = 0;
+            break;
+        }
+    }
+
+    free(useCounts);
+    free(usedPhiValues);
+    free(isDerived);
+
+    return isDead;
+
+}
+
+// Linear function test replacement: the bottom test compares the reduced value with base + bound * multiplier
+// instead of the induction variable with the bound. The differences of the compared values are multiplied by the
+// multiplier, so the loop is simulated to check that every test still gives the same result on 16-bit words.
+static int replaceLoopTest(ControlFlowGraph* graph, int inductionVariable, int entryValue, int step, ReducedInductionVariable* reduced, IntermediateInstruction* comparison, IntermediateInstruction* label) {
+
+    IntermediateInstruction* definition = graph->values[entryValue].definition;
+    int isInductionVariableLeft = isLiteralOperand(comparison->right);
+    Operand bound = isInductionVariableLeft ? comparison->right : comparison->left;
+    int comparedValue = isInductionVariableLeft ? comparison->leftValue : comparison->rightValue;
+    Operand slot = { opdtTemporary, stInt, reduced->slot };
+    Operand limit = { opdtInteger, stInt, 0 };
+    int multiplier = reduced->multiplier;
+    int scaledBound;
+    int offset;
+    int value;
+    int condition;
+    int iterations = 0;
+
+    if (comparison->operation != icRelational && !isComparisonJump(comparison)) return 0;
+    if (!isLiteralOperand(bound) || !getInductionOffset(graph, inductionVariable, comparedValue, &offset) || offset != step) return 0;
+    if (definition == NULL || definition->operation != icAttribution || !isLiteralOperand(definition->left)) return 0;
+
+    scaledBound = (int)(((unsigned)bound.value * (unsigned)multiplier) & 0xffff);
+
+    // The body runs once before the first test
+    value = definition->left.value & 0xffff;
+    do {
+        int scaledCondition;
+        value = (value + step) & 0xffff;
+        if (isInductionVariableLeft) {
+            foldOperation(comparison->operator, value, bound.value & 0xffff, &condition);
+            foldOperation(comparison->operator, (int)(((unsigned)value * (unsigned)multiplier) & 0xffff), scaledBound, &scaledCondition);
+        } else {
+            foldOperation(comparison->operator, bound.value & 0xffff, value, &condition);
+            foldOperation(comparison->operator, scaledBound, (int)(((unsigned)value * (unsigned)multiplier) & 0xffff), &scaledCondition);
+        }
+        if (condition != scaledCondition) return 0;
+        iterations++;
+    } while (condition && iterations < MAX_TRIP_COUNT);
+    if (condition) return 0;
+
+    // Limit of the reduced value
+    if (isLiteralOperand(reduced->base)) {
+        limit.value = (reduced->base.value + scaledBound) & 0xffff;
+        if (limit.value > MAX_IMMEDIATE_VALUE) return 0;
+    } else {
+        if (scaledBound > MAX_IMMEDIATE_VALUE) return 0;
+        limit.type = opdtTemporary;
+        limit.value = graph->function->activationRecordSize++;
+        insertAddition(graph->function, limit.value, reduced->base, scaledBound, label);
+    }
+
+    if (isInductionVariableLeft) {
+        comparison->left = slot;
+        comparison->right = limit;
+    } else {
+        comparison->left = limit;
+        comparison->right = slot;
+    }
+    comparison->leftValue = NO_VALUE;
+    comparison->rightValue = NO_VALUE;
+
+    return 1;
+
+}
+
+// Reduces the values base + induction variable * literal computed in the loop of the header, if it is a guarded
+// do-while loop entered from the previous block. Their slots are initialized in front of the label and increased
+// before the bottom test. Returns the number of values reduced.
+static int reduceLoopInductionVariables(ControlFlowGraph* graph, int header) {
+
+    IntermediateFunction* function = graph->function;
+    BasicBlock* headerBlock = &graph->blocks[header];
+    IntermediateInstruction* label = headerBlock->firstInstruction;
+    IntermediateInstruction* preheaderEnd = graph->blocks[header - 1].lastInstruction;
+    IntermediateInstruction* test;
+    IntermediateInstruction* comparison;
+    char* isLoopBlock = malloc(graph->blockCount);
+    ReducedInductionVariable* reducedValues;
+    int latchIndex;
+    int reducedCount = 0;
+
+    test = findBottomTest(graph, header, isLoopBlock);
+    if (test == NULL || headerBlock->predecessorCount != 2 || (preheaderEnd != NULL && (preheaderEnd->operation == icJump || preheaderEnd->operation == icReturn))) {
+        free(isLoopBlock);
+        return 0;
+    }
+    latchIndex = isLoopBlock[headerBlock->predecessors[0]] ? 0 : 1;
+    if (isLoopBlock[headerBlock->predecessors[1 - latchIndex]] || headerBlock->predecessors[1 - latchIndex] != header - 1) {
+        free(isLoopBlock);
+        return 0;
+    }
+
+    // The reduced values are increased just before the bottom test, or the comparison it tests
+    comparison = test;
+    if (!isComparisonJump(test) && test->previousInstruction->operation == icRelational && test->leftValue != NO_VALUE && test->previousInstruction->resultValue == test->leftValue) comparison = test->previousInstruction;
+
+    reducedValues = malloc((graph->valueCount + 1) * sizeof(ReducedInductionVariable));
+
+    for (int i = 0; i < headerBlock->phiFunctionCount; i++) {
+
+        int inductionVariable = headerBlock->phiFunctions[i].value;
+        int entryValue = headerBlock->phiFunctions[i].arguments[1 - latchIndex];
+        int count = 0;
+        int step;
+
+        if (!getInductionOffset(graph, inductionVariable, headerBlock->phiFunctions[i].arguments[latchIndex], &step) || step == 0) continue;
+
+        for (int block = header; block < graph->blockCount; block++) {
+
+            if (!isLoopBlock[block]) continue;
+
+            for (IntermediateInstruction* instruction = graph->blocks[block].firstInstruction; instruction != getBlockEnd(&graph->blocks[block]); instruction = instruction->nextInstruction) {
+
+                IntermediateInstruction* product;
+                Operand slot = { opdtTemporary, stInt, 0 };
+                Operand base;
+                int baseValue;
+                int multiplier;
+                int offset;
+                int j;
+
+                if (instruction->operation != icArithmetic || instruction->operator != oprAdd || instruction->resultValue == NO_VALUE) continue;
+
+                // Base plus product, in any order. The base has the same value in every iteration.
+                product = instruction->rightValue != NO_VALUE ? graph->values[instruction->rightValue].definition : NULL;
+                multiplier = getInductionMultiplier(graph, inductionVariable, product, &offset);
+                base = instruction->left;
+                baseValue = instruction->leftValue;
+                if (multiplier == 0) {
+                    product = instruction->leftValue != NO_VALUE ? graph->values[instruction->leftValue].definition : NULL;
+                    multiplier = getInductionMultiplier(graph, inductionVariable, product, &offset);
+                    base = instruction->right;
+                    baseValue = instruction->rightValue;
+                }
+                if (multiplier == 0) continue;
+                if (baseValue == NO_VALUE ? !isLiteralOperand(base) : isLoopBlock[graph->values[baseValue].block]) continue;
+                if (!fitsInLiteral(multiplier * offset) || !fitsInLiteral(multiplier * step)) continue;
+
+                // Values with the same base and multiplier share their slot
+                for (j = 0; j < count; j++) {
+                    if (reducedValues[j].multiplier == multiplier && reducedValues[j].baseValue == baseValue && (baseValue != NO_VALUE || reducedValues[j].base.value == base.value)) break;
+                }
+                if (j == count) {
+                    reducedValues[j].multiplier = multiplier;
+                    reducedValues[j].base = base;
+                    reducedValues[j].baseValue = baseValue;
+                    reducedValues[j].slot = function->activationRecordSize++;
+                    initializeReducedInductionVariable(graph, inductionVariable, entryValue, &reducedValues[j], label);
+                    slot.value = reducedValues[j].slot;
+                    insertAddition(function, slot.value, slot, multiplier * step, comparison);
+                    count++;
+                }
+
+                slot.value = reducedValues[j].slot;
+                setAddition(instruction, slot, multiplier * offset);
+                reducedInductionVariables++;
+
+            }
+
+        }
+
+        // The bottom test may then be the only use of the induction variable left
+        if (count > 0 && isInductionVariableOtherwiseDead(graph, inductionVariable, comparison)) replacedLoopTests += replaceLoopTest(graph, inductionVariable, entryValue, step, &reducedValues[0], comparison, label);
+
+        reducedCount += count;
+
+    }
+
+    free(reducedValues);
+    free(isLoopBlock);
+
+    return reducedCount;
+
+}
+
+// Loops are processed from the last header, so inner loops are reduced before the loops containing them. Returns
+// the number of values reduced.
+static int reduceInductionVariables(IntermediateFunction* function) {
+
+    char* processedLabels = calloc(function->labelCounter + 1, sizeof(char));
+    int reducedCount = 0;
+    int header;
+
+    do {
+
+        ControlFlowGraph* graph = buildControlFlowGraph(function);
+        buildStaticSingleAssignmentForm(graph);
+
+        for (header = graph->blockCount - 1; header > 0; header--) {
+            IntermediateInstruction* label = graph->blocks[header].firstInstruction;
+            if (isLoopHeader(graph, header) && !processedLabels[label->label]) break;
+        }
+
+        if (header > 0) {
+            processedLabels[graph->blocks[header].firstInstruction->label] = 1;
+            reducedCount += reduceLoopInductionVariables(graph, header);
+        }
+
+        freeControlFlowGraph(graph);
+
+    } while (header > 0);
+
+    free(processedLabels);
+
+    return reducedCount;
+
+}
+
+
+// BOUNDS CHECK ELIMINATION
+
+// Smallest and largest signed words
+#define MIN_WORD -0x8000
+#define MAX_WORD 0x7fff
+
+// Value copied by the copies which define the value
+static int getCopiedValue(ControlFlowGraph* graph, int value) {
+    while (value != NO_VALUE && graph->values[value].definition != NULL && graph->values[value].definition->operation == icAttribution && graph->values[value].definition->leftValue != NO_VALUE) value = graph->values[value].definition->leftValue;
+    return value;
+}
+
+// Narrows the range to [minimum, maximum], unless that interval wraps around the words
+static void narrowRange(int* range, int minimum, int maximum) {
+    if (minimum < MIN_WORD || maximum > MAX_WORD) return;
+    if (minimum > range[0]) range[0] = minimum;
+    if (maximum < range[1]) range[1] = maximum;
+}
+
+// Narrows the range of the value given that the comparison has the given result. Comparisons test the sign of the
+// difference of their operands (see foldOperation), which is bounded first.
+static void narrowRangeByComparison(ControlFlowGraph* graph, int value, Operator operator, Operand left, int leftValue, Operand right, int rightValue, int result, int* range) {
+
+    int minimum;
+    int maximum;
+
+    // Comparison which is true
+    if (!result) {
+        switch (operator) {
+            case oprSmallerThan: operator = oprBiggerOrEqualThan; break;
+            case oprSmallerOrEqualThan: operator = oprBiggerThan; break;
+            case oprBiggerThan: operator = oprSmallerOrEqualThan; break;
+            case oprBiggerOrEqualThan: operator = oprSmallerThan; break;
+            case oprEquals: operator = oprDifferent; break;
+            case oprDifferent: operator = oprEquals; break;
+            default: return;
+        }
+    }
+
+    switch (operator) {
+        case oprSmallerThan: minimum = MIN_WORD; maximum = -1; break;
+        case oprSmallerOrEqualThan: minimum = MIN_WORD; maximum = 0; break;
+        case oprBiggerThan: minimum = 1; maximum = MAX_WORD; break;
+        case oprBiggerOrEqualThan: minimum = 0; maximum = MAX_WORD; break;
+        case oprEquals: minimum = maximum = 0; break;
+        default: return;
+    }
+
+    // value - literal, or literal - value
+    if (isLiteralOperand(right) && getCopiedValue(graph, leftValue) == value) narrowRange(range, minimum + getSignedWord(right.value), maximum + getSignedWord(right.value));
+    else if (isLiteralOperand(left) && getCopiedValue(graph, rightValue) == value) narrowRange(range, getSignedWord(left.value) - maximum, getSignedWord(left.value) - minimum);
+
+}
+
+// Finds the range of the index of a check from its literal, the induction variables of loops with a known trip
+// count, the conditional jumps taken to reach the check and the checks of the same value which dominate it
+static void findIndexRange(ControlFlowGraph* graph, int block, IntermediateInstruction* check, InductionRange* inductionRanges, int inductionRangeCount, IntermediateInstruction** checks, int* checkBlocks, int checkCount, int* range) {
+
+    int value = getCopiedValue(graph, check->leftValue);
+    int offset;
+
+    range[0] = MIN_WORD;
+    range[1] = MAX_WORD;
+
+    if (isLiteralOperand(check->left)) {
+        range[0] = range[1] = getSignedWord(check->left.value);
+        return;
+    }
+    if (value == NO_VALUE) return;
+
+    for (int i = 0; i < inductionRangeCount; i++) {
+        if (getInductionOffset(graph, inductionRanges[i].inductionVariable, check->leftValue, &offset)) narrowRange(range, inductionRanges[i].minimum + offset, inductionRanges[i].maximum + offset);
+    }
+
+    // Edges from a conditional jump to a block with no other predecessor, on the path of dominators
+    for (int current = block; current > 0; current = graph->blocks[current].immediateDominator) {
+
+        BasicBlock* currentBlock = &graph->blocks[current];
+        BasicBlock* predecessor;
+        IntermediateInstruction* jump;
+        IntermediateInstruction* comparison;
+        int result;
+
+        if (currentBlock->predecessorCount != 1) continue;
+        predecessor = &graph->blocks[currentBlock->predecessors[0]];
+        jump = predecessor->lastInstruction;
+        if (jump == NULL || !isConditionalJump(jump) || predecessor->successorCount != 2) continue;
+
+        // The jump is taken to reach the block unless it is the next one
+        result = (predecessor->successors[1] == current) == (jump->operation == icJumpIfTrue);
+
+        if (isComparisonJump(jump)) narrowRangeByComparison(graph, value, jump->operator, jump->left, jump->leftValue, jump->right, jump->rightValue, result, range);
+        else if (jump->leftValue != NO_VALUE && (comparison = graph->values[jump->leftValue].definition) != NULL && comparison->operation == icRelational) {
+            narrowRangeByComparison(graph, value, comparison->operator, comparison->left, comparison->leftValue, comparison->right, comparison->rightValue, result, range);
+        }
+
+    }
+
+    // Checks kept before this one: the program stops if they fail
+    for (int i = 0; i < checkCount; i++) {
+        if (getCopiedValue(graph, checks[i]->leftValue) == value && dominates(graph, checkBlocks[i], block)) narrowRange(range, 0, checks[i]->size - 1);
+    }
+
+}
+
+// Removes the bounds checks whose index is always within the bounds of the dimension
+static void eliminateBoundsChecks(ControlFlowGraph* graph) {
+
+    InductionRange* inductionRanges = malloc(graph->blockCount * sizeof(InductionRange));
+    IntermediateInstruction** checks = NULL;
+    int* checkBlocks = NULL;
+    char* isLoopBlock = malloc(graph->blockCount);
+    int inductionRangeCount = 0;
+    int checkCount = 0;
+    int range[2];
+
+    for (int header = 1; header < graph->blockCount; header++) {
+        IntermediateInstruction* test;
+        if (!graph->blocks[header].isReachable || !isLoopHeader(graph, header)) continue;
+        test = findBottomTest(graph, header, isLoopBlock);
+        if (test != NULL && findTripCount(graph, header, test, &inductionRanges[inductionRangeCount]) > 0) inductionRangeCount++;
+    }
+
+    // Blocks in reverse postorder, so the checks which dominate a check are found before it
+    for (int i = 0; i < graph->reachableBlockCount; i++) {
+
+        int block = graph->reversePostorder[i];
+        IntermediateInstruction* end = getBlockEnd(&graph->blocks[block]);
+        IntermediateInstruction* nextInstruction;
+
+        for (IntermediateInstruction* instruction = graph->blocks[block].firstInstruction; instruction != end; instruction = nextInstruction) {
+
+            nextInstruction = instruction->nextInstruction;
+            if (instruction->operation != icBoundsCheck) continue;
+
+            findIndexRange(graph, block, instruction, inductionRanges, inductionRangeCount, checks, checkBlocks, checkCount, range);
+            if (range[0] >= 0 && range[1] < instruction->size) {
+                removeIntermediateInstruction(graph->function, instruction);
+                eliminatedBoundsChecks++;
+                continue;
+            }
+
+            checks = realloc(checks, (checkCount + 1) * sizeof(IntermediateInstruction*));
+            checkBlocks = realloc(checkBlocks, (checkCount + 1) * sizeof(int));
+            checks[checkCount] = instruction;
+            checkBlocks[checkCount++] = block;
+
+        }
+
+    }
+
+    free(checkBlocks);
+    free(checks);
+    free(isLoopBlock);
+    free(inductionRanges);
+
+}
+
+
+// COMPARISON FUSION
+
+// A conditional jump on the result of the comparison just before it compares the operands itself
+static void fuseComparisons(ControlFlowGraph* graph) {
+
+    int* useCounts = calloc(graph->valueCount + 1, sizeof(int));
+    char* usedPhiValues = calloc(graph->valueCount + 1, sizeof(char));
+
+    // Uses by instructions, and by phi functions whose value is read
+    markUsedPhiFunctions(graph, usedPhiValues);
+    for (int block = 1; block < graph->blockCount; block++) {
+        BasicBlock* current = &graph->blocks[block];
+        for (int i = 0; i < current->phiFunctionCount; i++) {
+            if (!usedPhiValues[current->phiFunctions[i].value]) continue;
+            for (int j = 0; j < current->predecessorCount; j++) useCounts[current->phiFunctions[i].arguments[j]]++;
+        }
+        for (IntermediateInstruction* instruction = current->firstInstruction; instruction != getBlockEnd(current); instruction = instruction->nextInstruction) {
+            if (instruction->leftValue != NO_VALUE) useCounts[instruction->leftValue]++;
+            if (instruction->rightValue != NO_VALUE) useCounts[instruction->rightValue]++;
+        }
+    }
+
+    for (int block = 1; block < graph->blockCount; block++) {
+
+        IntermediateInstruction* jump = graph->blocks[block].lastInstruction;
+        IntermediateInstruction* comparison;
+
+        if (jump == NULL || !isConditionalJump(jump) || isComparisonJump(jump) || jump->leftValue == NO_VALUE) continue;
+
+        comparison = jump->previousInstruction;
+        if (comparison == NULL || comparison->operation != icRelational || comparison->resultValue != jump->leftValue) continue;
+        if (useCounts[jump->leftValue] != 1) continue;
+
+        jump->operator = comparison->operator;
+        jump->left = comparison->left;
+        jump->right = comparison->right;
+        jump->leftValue = comparison->leftValue;
+        jump->rightValue = comparison->rightValue;
+        removeIntermediateInstruction(graph->function, comparison);
+        fusedComparisons++;
+
+    }
+
+    free(usedPhiValues);
+    free(useCounts);
+
+}
+
+
+// TAIL CALL ELIMINATION
+
+// Returns 1 if the function returns right after the call (labels aside), with the value returned by the call if
+// it has one
+static int isTailCall(IntermediateFunction* function, IntermediateInstruction* call) {
+
+    IntermediateInstruction* next;
+
+    for (next = call->nextInstruction; next != NULL && next->operation == icLabel; next = next->nextInstruction);
+    if (next == NULL) return function->returnValueSize == 0;
+    if (next->operation != icReturn) return 0;
+
+    return next->size == 0 || (next->left.type == opdtTemporary && next->left.value == call->result.value);
+
+}
+
+// Returns the first parameter passed just before a call of the function to itself (the call if there is none),
+// or NULL if one of them is not a scalar
+static IntermediateInstruction* findFirstParameter(IntermediateFunction* function, IntermediateInstruction* call) {
+
+    IntermediateInstruction* firstParameter = call;
+
+    while (firstParameter->previousInstruction != NULL && firstParameter->previousInstruction->operation == icParameter && firstParameter->previousInstruction->function == function->index) firstParameter = firstParameter->previousInstruction;
+    for (IntermediateInstruction* parameter = firstParameter; parameter != call; parameter = parameter->nextInstruction) {
+        if (parameter->size != 1) return NULL;
+    }
+
+    return firstParameter;
+
+}
+
+// Inserts the label of the beginning of the body in front of the instruction
+static IntermediateInstruction* insertBodyLabel(IntermediateFunction* function, IntermediateInstruction* nextInstruction) {
+
+    IntermediateInstruction* bodyLabel = insertIntermediateInstruction(function, icLabel, nextInstruction);
+    bodyLabel->label = newIntermediateLabel(function);
+    bodyLabel->comment = "Function body";
+
+    return bodyLabel;
+
+}
+
+// Replaces a call of the function to itself by the copy of its arguments to the parameters and a jump back to the
+// beginning of the body, so the activation record is reused. The arguments reading a parameter written before
+// them (in the order they are passed) are copied to new slots first.
+static void replaceTailCall(IntermediateFunction* function, IntermediateInstruction* call, IntermediateInstruction* firstParameter, int bodyLabel) {
+
+    IntermediateInstruction* parameter;
+    IntermediateInstruction* jump;
+
+    for (parameter = firstParameter; parameter != call; parameter = parameter->nextInstruction) {
+        for (IntermediateInstruction* written = firstParameter; written != parameter; written = written->nextInstruction) {
+            if (parameter->left.type == opdtVariable && parameter->left.value == written->address) {
+                IntermediateInstruction* copy = insertIntermediateInstruction(function, icAttribution, firstParameter);
+                Operand slot = { opdtTemporary, parameter->left.operandSymbolType, function->activationRecordSize++ };
+                copy->result = slot;
+                copy->left = parameter->left;
+                parameter->left = slot;
+                break;
+            }
+        }
+    }
+
+    for (parameter = firstParameter; parameter != call; parameter = parameter->nextInstruction) {
+        Operand slot = { opdtVariable, parameter->left.operandSymbolType, parameter->address };
+        parameter->operation = icAttribution;
+        parameter->result = slot;
+    }
+
+    jump = insertIntermediateInstruction(function, icJump, call);
+    jump->label = bodyLabel;
+    jump->comment = "Tail call";
+    removeIntermediateInstruction(function, call);
+
+}
+
+// Once the function no longer calls itself, it only needs a static activation record if no other cycle of the
+// call graph goes through it
+static void removeSelfCalls(IntermediateFunction* function) {
+
+    for (IntermediateInstruction* instruction = function->firstInstruction; instruction != NULL; instruction = instruction->nextInstruction) {
+        if (instruction->operation == icFunctionCall && instruction->function == function->index) return;
+    }
+
+    removeCallGraphEdge(function->index, function->index);
+    if (!isRecursiveFunction(function->index)) {
+        function->hasStaticActivationRecord = 1;
+        function->usesLightCallingConvention = 0;
+    }
+
+}
+
+// A call of the function to itself followed by a return is replaced by a jump back to the beginning of the body.
+// Returns the number of calls replaced.
+static int eliminateTailCalls(IntermediateFunction* function) {
+
+    IntermediateInstruction* bodyLabel = NULL;
+    IntermediateInstruction* nextInstruction;
+    int eliminatedCalls = 0;
+
+    if (function->isMain || function->returnValueSize > 1) return 0;
+
+    for (IntermediateInstruction* call = function->firstInstruction; call != NULL; call = nextInstruction) {
+
+        IntermediateInstruction* firstParameter;
+
+        nextInstruction = call->nextInstruction;
+        if (call->operation != icFunctionCall || call->function != function->index || !isTailCall(function, call)) continue;
+        if (bodyLabel == NULL && function->labelCounter >= MAX_UNROLLED_LABEL) continue;
+        if ((firstParameter = findFirstParameter(function, call)) == NULL) continue;
+
+        if (bodyLabel == NULL) bodyLabel = insertBodyLabel(function, function->firstInstruction);
+        if (call->nextInstruction != NULL && call->nextInstruction->operation == icReturn) removeIntermediateInstruction(function, call->nextInstruction);
+        nextInstruction = call->nextInstruction;
+        replaceTailCall(function, call, firstParameter, bodyLabel->label);
+        eliminatedCalls++;
+
+    }
+
+    if (eliminatedCalls > 0) removeSelfCalls(function);
+
+    return eliminatedCalls;
+
+}
+
+
+// ACCUMULATOR INTRODUCTION
+
+// Returns 1 if both operands are the same slot of the activation record
+static int isSameSlot(Operand first, Operand second) {
+    return (first.type == opdtVariable || first.type == opdtTemporary) && (second.type == opdtVariable || second.type == opdtTemporary) && first.value == second.value;
+}
+
+// Returns 1 if the value returned by a call of the function to itself is returned right away, after being copied
+// and at most added to or multiplied by an operand computed before the call. The addition or multiplication is
+// placed in operation (NULL if there is none), its other operand in accumulated and the return in returnInstruction.
+static int findAccumulatedOperation(IntermediateInstruction* call, IntermediateInstruction** operation, Operand* accumulated, IntermediateInstruction** returnInstruction) {
+
+    Operand current = call->result;
+
+    *operation = NULL;
+
+    for (IntermediateInstruction* instruction = call->nextInstruction; instruction != NULL; instruction = instruction->nextInstruction) {
+
+        if (instruction->operation == icReturn) {
+            *returnInstruction = instruction;
+            return instruction->size == 1 && isSameSlot(instruction->left, current);
+        }
+
+        if (instruction->operation == icAttribution && isSameSlot(instruction->left, current)) current = instruction->result;
+        else if (instruction->operation == icArithmetic && *operation == NULL && (instruction->operator == oprAdd || instruction->operator == oprMultiply) && isSameSlot(instruction->left, current) != isSameSlot(instruction->right, current)) {
+
+            *accumulated = isSameSlot(instruction->left, current) ? instruction->right : instruction->left;
+            if (accumulated->type != opdtVariable && accumulated->type != opdtTemporary && !isLiteralOperand(*accumulated)) return 0;
+
+            // The operand must hold the same value before the call
+            if (isSameSlot(*accumulated, call->result)) return 0;
+            for (IntermediateInstruction* written = call->nextInstruction; written != instruction; written = written->nextInstruction) {
+                if (isSameSlot(*accumulated, written->result)) return 0;
+            }
+
+            *operation = instruction;
+            current = instruction->result;
+
+        }
+        else return 0;
+
+    }
+
+    return 0;
+
+}
+
+// A function returning its call to itself added to or multiplied by a value, such as n * f(n - 1), computes that
+// operation on an accumulator slot instead, which starts with the identity of the operator, and then jumps back
+// to the beginning of the body like a tail call. Its other returns give the accumulator combined with their value.
+// Returns the number of calls replaced.
+static int introduceAccumulator(IntermediateFunction* function) {
+
+    IntermediateInstruction* operation;
+    IntermediateInstruction* returnInstruction;
+    IntermediateInstruction* nextInstruction;
+    IntermediateInstruction* initialization;
+    IntermediateInstruction* bodyLabel;
+    IntermediateInstruction* call;
+    Operand accumulated;
+    Operand accumulator = { opdtTemporary, stInt, 0 };
+    Operand returnedValue = { opdtTemporary, stInt, 0 };
+    Operator operator = oprAdd;
+    int replacedCalls = 0;
+
+    if (function->isMain || function->returnValueSize != 1 || function->labelCounter >= MAX_UNROLLED_LABEL) return 0;
+
+    // The operator of the first call whose value is combined before being returned
+    for (call = function->firstInstruction; call != NULL; call = call->nextInstruction) {
+        if (call->operation == icFunctionCall && call->function == function->index && findFirstParameter(function, call) != NULL && findAccumulatedOperation(call, &operation, &accumulated, &returnInstruction) && operation != NULL) break;
+    }
+    if (call == NULL) return 0;
+    operator = operation->operator;
+
+    accumulator.value = function->activationRecordSize++;
+    initialization = insertIntermediateInstruction(function, icAttribution, function->firstInstruction);
+    initialization->result = accumulator;
+    initialization->left.type = opdtInteger;
+    initialization->left.operandSymbolType = stInt;
+    initialization->left.value = operator == oprAdd ? 0 : 1;
+    bodyLabel = insertBodyLabel(function, initialization->nextInstruction);
+
+    for (call = bodyLabel->nextInstruction; call != NULL; call = nextInstruction) {
+
+        IntermediateInstruction* firstParameter;
+
+        nextInstruction = call->nextInstruction;
+        if (call->operation != icFunctionCall || call->function != function->index) continue;
+        if ((firstParameter = findFirstParameter(function, call)) == NULL) continue;
+        if (!findAccumulatedOperation(call, &operation, &accumulated, &returnInstruction) || (operation != NULL && operation->operator != operator)) continue;
+
+        if (operation != NULL) {
+            IntermediateInstruction* update = insertIntermediateInstruction(function, icArithmetic, firstParameter);
+            update->operator = operator;
+            update->result = accumulator;
+            update->left = accumulator;
+            update->right = accumulated;
+            update->comment = "Accumulator";
+        }
+
+        while (call->nextInstruction != returnInstruction) removeIntermediateInstruction(function, call->nextInstruction);
+        removeIntermediateInstruction(function, returnInstruction);
+        nextInstruction = call->nextInstruction;
+        replaceTailCall(function, call, firstParameter, bodyLabel->label);
+        replacedCalls++;
+
+    }
+
+    // The remaining returns give the value accumulated so far
+    returnedValue.value = function->activationRecordSize++;
+    for (IntermediateInstruction* instruction = bodyLabel->nextInstruction; instruction != NULL; instruction = instruction->nextInstruction) {
+        if (instruction->operation == icReturn) {
+            IntermediateInstruction* combination = insertIntermediateInstruction(function, icArithmetic, instruction);
+            combination->operator = operator;
+            combination->result = returnedValue;
+            combination->left = accumulator;
+            combination->right = instruction->left;
+            instruction->left = returnedValue;
+        }
+    }
+
+    removeSelfCalls(function);
+
+    return replacedCalls;
+
+}
+
+
+// COMPILE-TIME EVALUATION
+
+// Activation record of a function interpreted at compile time, with the slots written so far
+typedef struct {
+    int* slots;
+    char* isWritten;
+    int size;
+} InterpretedFrame;
+
+static InterpretedFrame newInterpretedFrame(IntermediateFunction* function) {
+    InterpretedFrame frame = { calloc(function->activationRecordSize, sizeof(int)), calloc(function->activationRecordSize, sizeof(char)), function->activationRecordSize };
+    return frame;
+}
+
+static void freeInterpretedFrame(InterpretedFrame* frame) {
+    free(frame->slots);
+    free(frame->isWritten);
+}
+
+// Slots never written would hold whatever the stack held, so reading them stops the interpretation
+static int readInterpretedOperand(InterpretedFrame* frame, Operand operand, int* value) {
+
+    if (isLiteralOperand(operand)) {
+        *value = operand.value & 0xffff;
+        return 1;
+    }
+
+    if (operand.type != opdtVariable && operand.type != opdtTemporary && operand.type != opdtElement) return 0;
+    if (operand.value < 0 || operand.value >= frame->size || !frame->isWritten[operand.value]) return 0;
+
+    *value = frame->slots[operand.value];
+    return 1;
+
+}
+
+static int writeInterpretedSlot(InterpretedFrame* frame, int slot, int value) {
+
+    if (slot < 0 || slot >= frame->size) return 0;
+
+    frame->slots[slot] = value & 0xffff;
+    frame->isWritten[slot] = 1;
+    return 1;
+
+}
+
+// Addresses are the offsets of the slots in bytes from the beginning of the activation record, like from svbptr.
+// Returns 0 if the address is out of the activation record.
+static int getInterpretedSlot(InterpretedFrame* frame, int address, int* slot) {
+    *slot = address / 2;
+    return address % 2 == 0 && *slot < frame->size;
+}
+
+static int interpretFunction(IntermediateFunction* function, InterpretedFrame* frame, int* returnedValue, int* remainingSteps);
+
+// Interprets the call with the arguments of the parameters passed just before it
+static int interpretFunctionCall(InterpretedFrame* frame, IntermediateInstruction* call, int* returnedValue, int* remainingSteps) {
+
+    IntermediateFunction* function = getIntermediateFunction(call->function);
+    InterpretedFrame calledFrame;
+    int isInterpreted = function->isPure;
+
+    if (!isInterpreted) return 0;
+
+    calledFrame = newInterpretedFrame(function);
+    for (IntermediateInstruction* parameter = call->previousInstruction; isInterpreted && parameter != NULL && parameter->operation == icParameter && parameter->function == call->function; parameter = parameter->previousInstruction) {
+        int argument;
+        isInterpreted = parameter->size == 1 && readInterpretedOperand(frame, parameter->left, &argument) && writeInterpretedSlot(&calledFrame, parameter->address, argument);
+    }
+
+    isInterpreted = isInterpreted && interpretFunction(function, &calledFrame, returnedValue, remainingSteps);
+    freeInterpretedFrame(&calledFrame);
+
+    return isInterpreted;
+
+}
+
+// Runs the function on its activation record, as the MVN would. Returns 0 if it does something which cannot be done
+// at compile time (input, output, reading an unknown value, signed division...) or if it runs out of steps.
+static int interpretFunction(IntermediateFunction* function, InterpretedFrame* frame, int* returnedValue, int* remainingSteps) {
+
+    IntermediateInstruction* instruction = function->firstInstruction;
+
+    while (instruction != NULL) {
+
+        IntermediateInstruction* nextInstruction = instruction->nextInstruction;
+        int left = 0;
+        int right = 0;
+        int result;
+        int slot;
+
+        if (--*remainingSteps < 0) return 0;
+
+        switch (instruction->operation) {
+
+            case icAttribution:
+                if (!readInterpretedOperand(frame, instruction->left, &left) || !writeInterpretedSlot(frame, instruction->result.value, left)) return 0;
+                break;
+
+            case icArithmetic:
+            case icRelational:
+            case icLogical:
+                if (!readInterpretedOperand(frame, instruction->left, &left) || !readInterpretedOperand(frame, instruction->right, &right)) return 0;
+                if (!foldOperation(instruction->operator, left, right, &result) || !writeInterpretedSlot(frame, instruction->result.value, result)) return 0;
+                break;
+
+            case icAddress:
+                if (!writeInterpretedSlot(frame, instruction->result.value, (instruction->left.value + instruction->address) * 2)) return 0;
+                break;
+
+            case icLoad:
+                if (!readInterpretedOperand(frame, instruction->left, &left) || !getInterpretedSlot(frame, left, &slot)) return 0;
+                if (!frame->isWritten[slot] || !writeInterpretedSlot(frame, instruction->result.value, frame->slots[slot])) return 0;
+                break;
+
+            case icStore:
+                if (!readInterpretedOperand(frame, instruction->left, &left) || !readInterpretedOperand(frame, instruction->right, &right)) return 0;
+                if (!getInterpretedSlot(frame, right, &slot) || !writeInterpretedSlot(frame, slot, left)) return 0;
+                break;
+
+            // The program would stop
+            case icBoundsCheck:
+                if (!readInterpretedOperand(frame, instruction->left, &left) || getSignedWord(left) < 0 || left >= instruction->size) return 0;
+                break;
+
+            case icLabel:
+            case icParameter:
+                break;
+
+            case icJump:
+                nextInstruction = findLabel(function, instruction->label);
+                break;
+
+            case icJumpIfFalse:
+            case icJumpIfTrue:
+                if (!readInterpretedOperand(frame, instruction->left, &left)) return 0;
+                if (isComparisonJump(instruction) && (!readInterpretedOperand(frame, instruction->right, &right) || !foldOperation(instruction->operator, left, right, &left))) return 0;
+                if ((left != 0) == (instruction->operation == icJumpIfTrue)) nextInstruction = findLabel(function, instruction->label);
+                break;
+
+            case icReturn:
+                return instruction->size == 0 || readInterpretedOperand(frame, instruction->left, returnedValue);
+
+            case icFunctionCall:
+                if (!interpretFunctionCall(frame, instruction, &result, remainingSteps)) return 0;
+                if (instruction->size == 1 && !writeInterpretedSlot(frame, instruction->result.value, result)) return 0;
+                break;
+
+            default:
+                return 0;
+
+        }
+
+        instruction = nextInstruction;
+
+    }
+
+    // The end of the body only returns a value if there is none
+    return function->returnValueSize == 0;
+
+}
+
+// The result of the call becomes the literal, or the literals whose product and sum give it if it does not fit in
+// a single one
+static void replaceCallByValue(IntermediateFunction* function, IntermediateInstruction* call, int value) {
+
+    IntermediateInstruction* product;
+    Operand literal = { opdtInteger, call->result.operandSymbolType, value };
+    Operand multiplier = { opdtInteger, stInt, 0x40 };
+
+    if (value <= MAX_IMMEDIATE_VALUE) {
+        call->operation = icAttribution;
+        call->left = literal;
+        return;
+    }
+
+    product = insertIntermediateInstruction(function, icArithmetic, call);
+    product->operator = oprMultiply;
+    product->result = call->result;
+    product->left = literal;
+    product->left.value = value / 0x40;
+    product->right = multiplier;
+
+    call->operation = icArithmetic;
+    call->operator = oprAdd;
+    call->left = call->result;
+    call->right = literal;
+    call->right.value = value % 0x40;
+
+}
+
+// Calls of pure functions whose arguments are literals are run by the interpreter within the step limit, and
+// replaced by the value they return. Returns the number of calls replaced.
+static int evaluateConstantCalls(IntermediateFunction* function) {
+
+    IntermediateInstruction* nextInstruction;
+    int replacedCalls = 0;
+
+    for (IntermediateInstruction* call = function->firstInstruction; call != NULL; call = nextInstruction) {
+
+        IntermediateInstruction* firstParameter = call;
+        InterpretedFrame frame = { NULL, NULL, 0 };
+        int remainingSteps = compilerOptions.evaluationLimit;
+        int value = 0;
+        int callee = call->function;
+
+        nextInstruction = call->nextInstruction;
+        if (call->operation != icFunctionCall || call->size > 1 || !getIntermediateFunction(callee)->isPure) continue;
+
+        while (firstParameter->previousInstruction != NULL && firstParameter->previousInstruction->operation == icParameter && firstParameter->previousInstruction->function == callee && isLiteralOperand(firstParameter->previousInstruction->left)) firstParameter = firstParameter->previousInstruction;
+        if (firstParameter->previousInstruction != NULL && firstParameter->previousInstruction->operation == icParameter && firstParameter->previousInstruction->function == callee) continue;
+
+        // The call reads the literal arguments, so it is interpreted from an empty activation record
+        if (!interpretFunctionCall(&frame, call, &value, &remainingSteps)) continue;
+
+        while (firstParameter != call) {
+            firstParameter = firstParameter->nextInstruction;
+            removeIntermediateInstruction(function, firstParameter->previousInstruction);
+        }
+        if (call->size == 1) replaceCallByValue(function, call, value);
+        else removeIntermediateInstruction(function, call);
+        replacedCalls++;
+
+        // The call graph only keeps the calls left
+        for (call = function->firstInstruction; call != NULL && !(call->operation == icFunctionCall && call->function == callee); call = call->nextInstruction);
+        if (call == NULL) removeCallGraphEdge(function->index, callee);
+
+    }
+
+    return replacedCalls;
+
+}
+
+
+// FUNCTION SPECIALIZATION
+
+// Largest number of constant parameters of a specialized function
+#define MAX_SPECIALIZED_PARAMETERS 8
+
+// Largest number of functions, so their labels fit in two digits
+#define MAX_FUNCTION_COUNT 0xff
+
+// Specialization of a function for the constants passed to some of its parameters, shared by the calls passing
+// the same ones
+typedef struct {
+    int function;
+    int parameterCount;
+    int addresses[MAX_SPECIALIZED_PARAMETERS];
+    Operand values[MAX_SPECIALIZED_PARAMETERS];
+    int specializedFunction;    // -1 if specializing the function does not pay off
+} Specialization;
+
+static Specialization* specializations = NULL;
+static int specializationCount = 0;
+static int specializationGrowth = 0;
+
+// Finds the literal arguments of the call. Returns the number of parameters found.
+static int findConstantParameters(IntermediateInstruction* call, Specialization* specialization) {
+
+    specialization->function = call->function;
+    specialization->parameterCount = 0;
+
+    for (IntermediateInstruction* parameter = call->previousInstruction; parameter != NULL && parameter->operation == icParameter && parameter->function == call->function; parameter = parameter->previousInstruction) {
+        if (parameter->size != 1 || !isLiteralOperand(parameter->left) || specialization->parameterCount == MAX_SPECIALIZED_PARAMETERS) continue;
+        specialization->addresses[specialization->parameterCount] = parameter->address;
+        specialization->values[specialization->parameterCount] = parameter->left;
+        specialization->parameterCount++;
+    }
+
+    return specialization->parameterCount;
+
+}
+
+// Returns the specialization of the function for the same constants, NULL if there is none yet
+static Specialization* findSpecialization(Specialization* specialization) {
+
+    for (int i = 0; i < specializationCount; i++) {
+
+        Specialization* existing = &specializations[i];
+        int j;
+
+        if (existing->function != specialization->function || existing->parameterCount != specialization->parameterCount) continue;
+        for (j = 0; j < existing->parameterCount && existing->addresses[j] == specialization->addresses[j] && existing->values[j].value == specialization->values[j].value; j++);
+        if (j == existing->parameterCount) return existing;
+
+    }
+
+    return NULL;
+
+}
+
+// Copies the function, its constant parameters being set at the beginning of its body, and propagates them. The
+// copy is only kept if it ends up smaller than the function, within the growth limit of the program. Returns the
+// index of the copy, or -1.
+static int specializeFunction(IntermediateFunction* function, Specialization* specialization) {
+
+    IntermediateFunction* specializedFunction;
+    int functionCount = 0;
+    char* name;
+
+    for (IntermediateFunction* other = getIntermediateFunctions(); other != NULL; other = other->nextFunction) functionCount++;
+    if (functionCount >= MAX_FUNCTION_COUNT || function->firstInstruction == NULL) return -1;
+    if (getIntermediateFunctionSize(function) > compilerOptions.specializationLimit) return -1;
+
+    specializedFunction = copyIntermediateFunction(function);
+    for (int i = 0; i < specialization->parameterCount; i++) {
+        IntermediateInstruction* constant = insertIntermediateInstruction(specializedFunction, icAttribution, specializedFunction->firstInstruction);
+        Operand parameter = { opdtVariable, specialization->values[i].operandSymbolType, specialization->addresses[i] };
+        constant->result = parameter;
+        constant->left = specialization->values[i];
+    }
+
+    runPass(specializedFunction, propagateConstants);
+    runPass(specializedFunction, numberValues);
+    runPass(specializedFunction, eliminateDeadStores);
+    runPass(specializedFunction, fuseComparisons);
+
+    if (getIntermediateFunctionSize(specializedFunction) >= getIntermediateFunctionSize(function) || specializationGrowth + getIntermediateFunctionSize(specializedFunction) > compilerOptions.specializationGrowth) {
+        freeIntermediateFunction(specializedFunction);
+        return -1;
+    }
+
+    insertIntermediateFunction(specializedFunction, function);
+    specializationGrowth += getIntermediateFunctionSize(specializedFunction);
+
+    name = malloc(strlen(function->name) + 16);
+    sprintf(name, "%s (specialized)", function->name);
+    specializedFunction->name = name;
+
+    for (IntermediateInstruction* call = specializedFunction->firstInstruction; call != NULL; call = call->nextInstruction) {
+        if (call->operation == icFunctionCall) addCallGraphEdge(specializedFunction->index, call->function);
+    }
+    specializedFunction->hasStaticActivationRecord = !isRecursiveFunction(specializedFunction->index);
+    specializedFunction->usesLightCallingConvention = compilerOptions.lightCalls && !specializedFunction->hasStaticActivationRecord && specializedFunction->returnValueSize <= 1;
+
+    return specializedFunction->index;
+
+}
+
+static int countSpecializedFunctions() {
+    int count = 0;
+    for (int i = 0; i < specializationCount; i++) count += specializations[i].specializedFunction >= 0;
+    return count;
+}
+
+// Calls passing literals to functions already optimized (optimizedFunctions come before the current one) call a
+// specialized copy of them instead, without passing the constant parameters. Returns the number of calls changed.
+static int specializeFunctionCalls(IntermediateFunction* optimizedFunctions, IntermediateFunction* function) {
+
+    IntermediateInstruction* nextInstruction;
+    int changedCalls = 0;
+
+    for (IntermediateInstruction* call = function->firstInstruction; call != NULL; call = nextInstruction) {
+
+        Specialization specialization;
+        Specialization* existing;
+        IntermediateFunction* callee;
+        int removedParameters = 0;
+        int callsCallee = 0;
+
+        nextInstruction = call->nextInstruction;
+        if (call->operation != icFunctionCall || findConstantParameters(call, &specialization) == 0) continue;
+
+        for (callee = optimizedFunctions; callee != function && callee->index != call->function; callee = callee->nextFunction);
+        if (callee == function) continue;
+
+        existing = findSpecialization(&specialization);
+        if (existing == NULL) {
+            specializations = realloc(specializations, (specializationCount + 1) * sizeof(Specialization));
+            existing = &specializations[specializationCount++];
+            *existing = specialization;
+            existing->specializedFunction = specializeFunction(callee, &specialization);
+        }
+        if (existing->specializedFunction < 0) continue;
+
+        for (IntermediateInstruction* parameter = call->previousInstruction; parameter != NULL && parameter->operation == icParameter && parameter->function == callee->index; ) {
+            IntermediateInstruction* previousParameter = parameter->previousInstruction;
+            if (parameter->size == 1 && isLiteralOperand(parameter->left) && removedParameters < existing->parameterCount) {
+                removeIntermediateInstruction(function, parameter);
+                removedParameters++;
+            }
+            else parameter->function = existing->specializedFunction;
+            parameter = previousParameter;
+        }
+        call->function = existing->specializedFunction;
+        addCallGraphEdge(function->index, existing->specializedFunction);
+        changedCalls++;
+
+        for (IntermediateInstruction* other = function->firstInstruction; other != NULL; other = other->nextInstruction) {
+            if (other->operation == icFunctionCall && other->function == callee->index) callsCallee = 1;
+        }
+        if (!callsCallee) removeCallGraphEdge(function->index, callee->index);
+
+    }
+
+    return changedCalls;
+
+}
+
+
+// IDENTICAL FUNCTION MERGING
+
+static int isSameOperand(Operand first, Operand second) {
+    return first.type == second.type && first.operandSymbolType == second.operandSymbolType && first.value == second.value;
+}
+
+// Calls of a function to itself are the same as the calls of the other one to itself
+static int isSameCalledFunction(IntermediateFunction* function, int called, IntermediateFunction* other, int otherCalled) {
+    if (called == function->index || otherCalled == other->index) return called == function->index && otherCalled == other->index;
+    return called == otherCalled;
+}
+
+// Returns 1 if both functions generate the same code, once their labels are renamed (the called function is only
+// read from calls and parameters)
+static int isSameFunction(IntermediateFunction* function, IntermediateFunction* other) {
+
+    IntermediateInstruction* instruction = function->firstInstruction;
+    IntermediateInstruction* otherInstruction = other->firstInstruction;
+
+    if (function->isMain || other->isMain) return 0;
+    if (function->activationRecordSize != other->activationRecordSize || function->returnValueSize != other->returnValueSize || function->firstParameterSize != other->firstParameterSize) return 0;
+    if (function->hasStaticActivationRecord != other->hasStaticActivationRecord || function->usesLightCallingConvention != other->usesLightCallingConvention) return 0;
+
+    for (; instruction != NULL && otherInstruction != NULL; instruction = instruction->nextInstruction, otherInstruction = otherInstruction->nextInstruction) {
+        if (instruction->operation != otherInstruction->operation || instruction->operator != otherInstruction->operator) return 0;
+        if (!isSameOperand(instruction->result, otherInstruction->result) || !isSameOperand(instruction->left, otherInstruction->left) || !isSameOperand(instruction->right, otherInstruction->right)) return 0;
+        if (instruction->label != otherInstruction->label || instruction->address != otherInstruction->address || instruction->size != otherInstruction->size || instruction->dataType != otherInstruction->dataType) return 0;
+        if ((instruction->operation == icFunctionCall || instruction->operation == icParameter) && !isSameCalledFunction(function, instruction->function, other, otherInstruction->function)) return 0;
+    }
+
+    return instruction == NULL && otherInstruction == NULL;
+
+}
+
+// Makes the calls of the duplicate (and the parameters passed to it) call the function instead
+static void replaceCalledFunction(IntermediateFunction* functions, IntermediateFunction* duplicate, IntermediateFunction* function) {
+    for (IntermediateFunction* caller = functions; caller != NULL; caller = caller->nextFunction) {
+        for (IntermediateInstruction* instruction = caller->firstInstruction; instruction != NULL; instruction = instruction->nextInstruction) {
+            if ((instruction->operation == icFunctionCall || instruction->operation == icParameter) && instruction->function == duplicate->index) instruction->function = function->index;
+        }
+    }
+}
+
+// Functions identical to a previous one are no longer called, the dead code elimination removes them. Merging
+// functions may make their callers identical too, so this is repeated until no function is merged.
+static void mergeIdenticalFunctions(IntermediateFunction* functions) {
+
+    int merged = 1;
+
+    while (merged) {
+        merged = 0;
+        for (IntermediateFunction* duplicate = functions; duplicate != NULL; duplicate = duplicate->nextFunction) {
+            for (IntermediateFunction* function = functions; function != duplicate; function = function->nextFunction) {
+                if (function->mergedFunctionCount < 0 || duplicate->mergedFunctionCount < 0 || !isSameFunction(function, duplicate)) continue;
+                replaceCalledFunction(functions, duplicate, function);
+                function->mergedFunctionCount += duplicate->mergedFunctionCount + 1;
+                duplicate->mergedFunctionCount = -1;
+                merged = 1;
+                break;
+            }
+        }
+    }
+
+}
+
+
+// DEAD CODE ELIMINATION
+
+// Removes the instructions which follow a jump or a return, up to the next label some jump goes to. Removing a
+// jump may leave its label unreachable too, so this is repeated until nothing is removed. Returns the number of
+// instructions removed.
+static int eliminateUnreachableInstructions(IntermediateFunction* function) {
+
+    int removedInstructions = 0;
+    int changed = 1;
+
+    while (changed) {
+
+        char* isJumpTarget;
+        int labelCount = 0;
+        int isReachable = 1;
+        IntermediateInstruction* nextInstruction;
+
+        for (IntermediateInstruction* instruction = function->firstInstruction; instruction != NULL; instruction = instruction->nextInstruction) {
+            if (instruction->operation == icLabel && instruction->label >= labelCount) labelCount = instruction->label + 1;
+        }
+        isJumpTarget = calloc(labelCount + 1, sizeof(char));
+
+        changed = 0;
+        for (IntermediateInstruction* instruction = function->firstInstruction; instruction != NULL; instruction = instruction->nextInstruction) {
+            if ((instruction->operation == icJump || isConditionalJump(instruction)) && instruction->label < labelCount) isJumpTarget[instruction->label] = 1;
+        }
+
+        for (IntermediateInstruction* instruction = function->firstInstruction; instruction != NULL; instruction = nextInstruction) {
+            nextInstruction = instruction->nextInstruction;
+            if (instruction->operation == icLabel && isJumpTarget[instruction->label]) isReachable = 1;
+            if (!isReachable) {
+                removeIntermediateInstruction(function, instruction);
+                removedInstructions++;
+                changed = 1;
+                continue;
+            }
+            if (instruction->operation == icJump || instruction->operation == icReturn) isReachable = 0;
+        }
+
+        free(isJumpTarget);
+
+    }
+
+    return removedInstructions;
+
+}
+
+// Removes the functions main can never call, once the unreachable instructions (and the calls among them) are
+// removed from all the functions
+static void eliminateDeadCode(IntermediateFunction* functions) {
+
+    IntermediateFunction* main = functions;
+    IntermediateFunction* nextFunction;
+
+    for (IntermediateFunction* function = functions; function != NULL; function = function->nextFunction) {
+        deadInstructions += eliminateUnreachableInstructions(function);
+        if (function->isMain) main = function;
+    }
+    updateCallGraph(functions);
+
+    for (IntermediateFunction* function = functions; function != NULL; function = nextFunction) {
+        nextFunction = function->nextFunction;
+        if (!canReachFunction(main->index, function->index)) {
+            removeIntermediateFunction(function);
+            deadFunctions++;
+        }
+    }
+
+}
+
+
+// PROGRAM
+
+// Evaluates the calls with constant arguments, until the values propagated from them give no new one
+static void evaluateFunctionConstantCalls(IntermediateFunction* function) {
+
+    int calls;
+
+    while ((calls = evaluateConstantCalls(function)) > 0) {
+        evaluatedCalls += calls;
+        runPass(function, propagateConstants);
+    }
+
+}
+
+void optimizeProgram(IntermediateFunction* functions) {
+
+    // Whatever the optimization level, the code which can never run takes no memory
+    eliminateDeadCode(functions);
+    functions = getIntermediateFunctions();
+    if (compilerOptions.optimizationLevel < 1) return;
+
+    // The functions which no longer call themselves may be inlined
+    for (IntermediateFunction* function = functions; function != NULL; function = function->nextFunction) {
+        accumulatedCalls += introduceAccumulator(function);
+        eliminatedTailCalls += eliminateTailCalls(function);
+    }
+
+    // Calls with constant arguments are evaluated before their function is inlined, and again once constants are
+    // propagated through the inlined code
+    if (compilerOptions.optimizationLevel >= 2) {
+        findPureFunctions(functions);
+        for (IntermediateFunction* function = functions; function != NULL; function = function->nextFunction) evaluateFunctionConstantCalls(function);
+        inlinedCalls = inlineFunctionCalls(functions);
+    }
+
+    for (IntermediateFunction* function = functions; function != NULL; function = function->nextFunction) {
+        if (compilerOptions.optimizationLevel >= 2) specializedCalls += specializeFunctionCalls(functions, function);
+        runPass(function, propagateConstants);
+        if (compilerOptions.optimizationLevel >= 2) evaluateFunctionConstantCalls(function);
+        runPass(function, numberValues);
+        if (compilerOptions.optimizationLevel >= 2) {
+            hoistFunctionLoopInvariants(function);
+            rotateLoops(function);
+        }
+        if (compilerOptions.boundsCheck) runPass(function, eliminateBoundsChecks);
+        if (compilerOptions.optimizationLevel >= 3 && unrollLoops(function) > 0) {
+            runPass(function, propagateConstants);
+            runPass(function, numberValues);
+            if (compilerOptions.boundsCheck) runPass(function, eliminateBoundsChecks);
+        }
+        if (compilerOptions.optimizationLevel >= 2 && reduceInductionVariables(function) > 0) {
+            runPass(function, propagateConstants);
+            runPass(function, numberValues);
+        }
+        runPass(function, eliminateDeadStores);
+        runPass(function, fuseComparisons);
+    }
+
+    // Inlining, specialization and merging leave functions which are no longer called
+    mergeIdenticalFunctions(functions);
+    eliminateDeadCode(functions);
+
+    if (compilerOptions.showStatistics) {
+        printf("SCCP: %d constants propagated, %d expressions folded, %d branches folded, %d unreachable instructions eliminated\n", propagatedConstants, foldedExpressions, foldedBranches, unreachableInstructions);
+        printf("GVN: %d redundant expressions eliminated, %d copies propagated\n", redundantExpressions, propagatedCopies);
+        printf("DSE: %d dead stores eliminated\n", deadStores);
+        printf("Tail calls: %d calls of functions to themselves turned into jumps\n", eliminatedTailCalls);
+        printf("Accumulators: %d calls of functions to themselves turned into jumps with an accumulator\n", accumulatedCalls);
+        printf("Comparison fusion: %d comparisons fused into jumps\n", fusedComparisons);
+        printf("Dead code: %d functions never called and %d unreachable instructions eliminated\n", deadFunctions, deadInstructions);
+        if (compilerOptions.boundsCheck) printf("Range analysis: %d bounds checks eliminated\n", eliminatedBoundsChecks);
+        if (compilerOptions.optimizationLevel >= 2) {
+            printf("Inlining: %d calls inlined\n", inlinedCalls);
+            printf("Specialization: %d calls turned into calls of %d specialized functions\n", specializedCalls, countSpecializedFunctions());
+            printf("Compile-time evaluation: %d calls of pure functions replaced by their value\n", evaluatedCalls);
+            printf("LICM: %d loop-invariant instructions hoisted\n", hoistedInstructions);
+            printf("Loop rotation: %d loops rotated\n", rotatedLoops);
+            printf("Strength reduction: %d induction expressions reduced, %d loop tests replaced\n", reducedInductionVariables, replacedLoopTests);
+        }
+        if (compilerOptions.optimizationLevel >= 3) printf("Loop unrolling: %d loops fully unrolled, %d loops partially unrolled\n", fullyUnrolledLoops, partiallyUnrolledLoops);
+    }
+
+    free(specializations);
+
+}
@@ -0,0 +1,362 @@
+/*!
+
+   Outliner.c
+
+   Author: agent
+   Updated: 2026-10-19
+
+ */
+
+#include "Outliner.h"
+
+// Longest outlined sequence (in instructions), and largest number of subroutines (their labels are oXXX)
+#define MAX_OUTLINED_LENGTH 32
+#define MAX_OUTLINED_SEQUENCES 0x1000
+
+#define MAX_LINE_SIZE 256
+#define LABEL_SIZE 8
+
+// Line of the generated code
+typedef struct {
+    char* text;             // Line as written by the code generator, NULL once it has been outlined
+    char label[LABEL_SIZE + 1];
+    int instruction;        // Index of the instruction in the instruction table, -1 if it cannot be outlined
+} CodeLine;
+
+// Subroutine holding an outlined sequence
+typedef struct {
+    int length;
+    int* instructions;
+} OutlinedSequence;
+
+static CodeLine* lines = NULL;
+static int lineCount = 0;
+
+// Distinct instructions which can be outlined ("mnemonic operand" as they are written)
+static char** instructions = NULL;
+static int instructionCount = 0;
+
+static OutlinedSequence* sequences = NULL;
+static int sequenceCount = 0;
+
+// Number of lines which can be outlined starting at each line
+static int* extents = NULL;
+
+// Statistics
+static int outlinedOccurrences = 0;
+static int savedWords = 0;
+
+// Instructions which do the same wherever they are, and environment sub-routines which never call the program back
+static const char* outlinedMnemonics[] = { "LD", "MM", "LV", "+", "-", "*", "/" };
+static const char* environmentSubroutines[] = { "ercad", "erwrt", "errd", "ercpb", "erbnd", "srpsa", "srppa", "srptv", "srwfra", "srrfra", "scani", "scans", "puti", "puts", "putb", "pbrkl" };
+
+
+// LINES
+
+static int isOutlinableInstruction(const char* mnemonic, const char* operand) {
+
+    for (size_t i = 0; i < sizeof(outlinedMnemonics) / sizeof(outlinedMnemonics[0]); i++) {
+        if (strcmp(mnemonic, outlinedMnemonics[i]) == 0) return 1;
+    }
+
+    if (strcmp(mnemonic, "SC") != 0) return 0;
+    for (size_t i = 0; i < sizeof(environmentSubroutines) / sizeof(environmentSubroutines[0]); i++) {
+        if (strcmp(operand, environmentSubroutines[i]) == 0) return 1;
+    }
+
+    return 0;
+
+}
+
+// Index of the instruction in the instruction table, which is added to it if it is new
+static int getInstructionIndex(const char* instruction) {
+
+    for (int i = 0; i < instructionCount; i++) {
+        if (strcmp(instructions[i], instruction) == 0) return i;
+    }
+
+    instructions = realloc(instructions, (instructionCount + 1) * sizeof(char*));
+    instructions[instructionCount] = malloc(strlen(instruction) + 1);
+    strcpy(instructions[instructionCount], instruction);
+
+    return instructionCount++;
+
+}
+
+// Reads the label and the instruction of the line. Comments, blank lines, directives and data cannot be outlined.
+static void parseLine(char* text, CodeLine* line) {
+
+    char mnemonic[MAX_LINE_SIZE];
+    char operand[MAX_LINE_SIZE];
+    char instruction[2 * MAX_LINE_SIZE];
+    int labelLength = 0;
+
+    line->text = text;
+    line->label[0] = '\0';
+    line->instruction = -1;
+
+    if (text[0] == ';' || text[0] == '\n' || text[0] == '\0') return;
+    if (text[0] != ' ' && sscanf(text, "%8s%n", line->label, &labelLength) != 1) return;
+    if (sscanf(text + labelLength, "%s %s", mnemonic, operand) != 2 || operand[0] == ';') return;
+
+    if (isOutlinableInstruction(mnemonic, operand)) {
+        sprintf(instruction, "%-4s%s", mnemonic, operand);
+        line->instruction = getInstructionIndex(instruction);
+    }
+
+}
+
+static void readLines(FILE* input) {
+
+    char text[MAX_LINE_SIZE];
+
+    rewind(input);
+    while (fgets(text, MAX_LINE_SIZE, input) != NULL) {
+        lines = realloc(lines, (lineCount + 1) * sizeof(CodeLine));
+        parseLine(strcpy(malloc(strlen(text) + 1), text), &lines[lineCount++]);
+    }
+
+}
+
+// Removes the lines which have been outlined
+static void compactLines() {
+
+    int count = 0;
+
+    for (int i = 0; i < lineCount; i++) {
+        if (lines[i].text != NULL) lines[count++] = lines[i];
+    }
+    lineCount = count;
+
+}
+
+
+// REPEATED SEQUENCES
+
+// A sequence runs through the following lines which can be outlined, up to the next label
+static void computeExtents() {
+
+    extents = realloc(extents, (lineCount + 1) * sizeof(int));
+    extents[lineCount] = 0;
+
+    for (int i = lineCount - 1; i >= 0; i--) {
+        if (lines[i].instruction < 0) extents[i] = 0;
+        else if (i + 1 < lineCount && lines[i + 1].label[0] == '\0') extents[i] = extents[i + 1] + 1;
+        else extents[i] = 1;
+    }
+
+    for (int i = 0; i < lineCount; i++) {
+        if (extents[i] > MAX_OUTLINED_LENGTH) extents[i] = MAX_OUTLINED_LENGTH;
+    }
+
+}
+
+// Number of instructions the sequences starting at both lines have in common
+static int getCommonLength(int first, int second) {
+
+    int length = 0;
+
+    while (length < extents[first] && length < extents[second] && lines[first + length].instruction == lines[second + length].instruction) length++;
+
+    return length;
+
+}
+
+// Orders the sequences starting at the lines lexicographically, so the ones beginning the same way are together
+static int compareSequences(const void* first, const void* second) {
+
+    int firstLine = *(const int*)first;
+    int secondLine = *(const int*)second;
+    int length = getCommonLength(firstLine, secondLine);
+
+    if (length < extents[firstLine] && length < extents[secondLine]) return lines[firstLine + length].instruction - lines[secondLine + length].instruction;
+    if (extents[firstLine] != extents[secondLine]) return extents[firstLine] - extents[secondLine];
+
+    return firstLine - secondLine;
+
+}
+
+static int compareLines(const void* first, const void* second) {
+    return *(const int*)first - *(const int*)second;
+}
+
+// Keeps the occurrences which do not overlap the previous ones, in the order of the lines. Returns their number.
+static int selectOccurrences(int* occurrences, int count, int length) {
+
+    int selectedCount = 0;
+
+    qsort(occurrences, count, sizeof(int), compareLines);
+    for (int i = 0; i < count; i++) {
+        if (selectedCount == 0 || occurrences[i] >= occurrences[selectedCount - 1] + length) occurrences[selectedCount++] = occurrences[i];
+    }
+
+    return selectedCount;
+
+}
+
+// Words saved by replacing the occurrences of a sequence by calls: the subroutine takes its label and a return
+static int getSavedWords(int length, int occurrenceCount) {
+    return occurrenceCount * length - occurrenceCount - (length + 2);
+}
+
+// Finds the sequence whose outlining saves the most words. Returns the words saved, placing the sequence length
+// in length and the lines where it occurs in occurrences (allocated, the caller frees them).
+static int findBestSequence(int* length, int** occurrences, int* occurrenceCount) {
+
+    int* sortedLines = malloc(lineCount * sizeof(int));
+    int* commonLengths = malloc(lineCount * sizeof(int));
+    int* groupLines = malloc(lineCount * sizeof(int));
+    int sortedCount = 0;
+    int bestSavedWords = 0;
+
+    computeExtents();
+    for (int i = 0; i < lineCount; i++) {
+        if (extents[i] >= 2) sortedLines[sortedCount++] = i;
+    }
+    qsort(sortedLines, sortedCount, sizeof(int), compareSequences);
+    for (int i = 1; i < sortedCount; i++) commonLengths[i] = getCommonLength(sortedLines[i - 1], sortedLines[i]);
+
+    *occurrences = NULL;
+
+    // Sequences of each length repeated by neighbouring lines of the sorted order
+    for (int sequenceLength = 2; sequenceLength <= MAX_OUTLINED_LENGTH; sequenceLength++) {
+        for (int first = 0, last; first < sortedCount; first = last + 1) {
+
+            int groupCount;
+            int selectedCount;
+
+            for (last = first; last + 1 < sortedCount && commonLengths[last + 1] >= sequenceLength; last++);
+            if (last == first) continue;
+
+            groupCount = last - first + 1;
+            memcpy(groupLines, &sortedLines[first], groupCount * sizeof(int));
+            selectedCount = selectOccurrences(groupLines, groupCount, sequenceLength);
+
+            if (getSavedWords(sequenceLength, selectedCount) > bestSavedWords) {
+                bestSavedWords = getSavedWords(sequenceLength, selectedCount);
+                *length = sequenceLength;
+                *occurrenceCount = selectedCount;
+                *occurrences = realloc(*occurrences, selectedCount * sizeof(int));
+                memcpy(*occurrences, groupLines, selectedCount * sizeof(int));
+            }
+
+        }
+    }
+
+    free(sortedLines);
+    free(commonLengths);
+    free(groupLines);
+
+    return bestSavedWords;
+
+}
+
+static void generateSequenceLabel(int sequence, char* label) {
+    sprintf(label, "o%03x", sequence);
+}
+
+// Moves the sequence to a new subroutine and replaces its occurrences by calls, keeping their labels
+static void outlineSequence(int length, int* occurrences, int occurrenceCount) {
+
+    OutlinedSequence* sequence;
+    char label[LABEL_SIZE + 1];
+    char call[MAX_LINE_SIZE];
+
+    sequences = realloc(sequences, (sequenceCount + 1) * sizeof(OutlinedSequence));
+    sequence = &sequences[sequenceCount];
+    sequence->length = length;
+    sequence->instructions = malloc(length * sizeof(int));
+    for (int i = 0; i < length; i++) sequence->instructions[i] = lines[occurrences[0] + i].instruction;
+    generateSequenceLabel(sequenceCount++, label);
+
+    for (int i = 0; i < occurrenceCount; i++) {
+        CodeLine* line = &lines[occurrences[i]];
+        sprintf(call, "%-8s%-4s%s\n", line->label, "SC", label);
+        free(line->text);
+        line->text = strcpy(malloc(strlen(call) + 1), call);
+        line->instruction = -1;
+        for (int j = 1; j < length; j++) {
+            free(line[j].text);
+            line[j].text = NULL;
+        }
+    }
+
+    compactLines();
+
+}
+
+
+// OUTPUT
+
+static void writeSequences(FILE* output) {
+
+    char label[LABEL_SIZE + 1];
+
+    for (int i = 0; i < sequenceCount; i++) {
+        generateSequenceLabel(i, label);
+        fprintf(output, "\n; Outlined sequence  [Label: %s]\n", label);
+        fprintf(output, "%-8sK   /0\n", label);
+        for (int j = 0; j < sequences[i].length; j++) fprintf(output, "        %s\n", instructions[sequences[i].instructions[j]]);
+        fprintf(output, "        RS  %s\n", label);
+    }
+
+}
+
+// The subroutines go before the comments introducing main, whose code is the last labelled main
+static void writeLines(FILE* output) {
+
+    int mainLine = lineCount;
+
+    for (int i = 0; i < lineCount; i++) {
+        if (strcmp(lines[i].label, "main") == 0) mainLine = i;
+    }
+    while (mainLine > 0 && lines[mainLine - 1].label[0] == '\0' && (lines[mainLine - 1].text[0] == ';' || lines[mainLine - 1].text[0] == '\n')) mainLine--;
+
+    for (int i = 0; i < lineCount; i++) {
+        if (i == mainLine) writeSequences(output);
+        fputs(lines[i].text, output);
+    }
+
+}
+
+static void freeOutliner() {
+
+    for (int i = 0; i < lineCount; i++) free(lines[i].text);
+    for (int i = 0; i < instructionCount; i++) free(instructions[i]);
+    for (int i = 0; i < sequenceCount; i++) free(sequences[i].instructions);
+    free(lines);
+    free(instructions);
+    free(sequences);
+    free(extents);
+
+}
+
+
+// PROGRAM
+
+void outlineProgram(FILE* input, FILE* output) {
+
+    int length;
+    int* occurrences;
+    int occurrenceCount;
+    int words = 1;
+
+    readLines(input);
+
+    while (words > 0 && sequenceCount < MAX_OUTLINED_SEQUENCES) {
+        words = findBestSequence(&length, &occurrences, &occurrenceCount);
+        if (words > 0) {
+            outlineSequence(length, occurrences, occurrenceCount);
+            outlinedOccurrences += occurrenceCount;
+            savedWords += words;
+        }
+        free(occurrences);
+    }
+
+    writeLines(output);
+
+    if (compilerOptions.showStatistics) printf("Outlining: %d sequences replaced by calls of %d subroutines, %d words saved\n", outlinedOccurrences, sequenceCount, savedWords);
+
+    freeOutliner();
+
+}
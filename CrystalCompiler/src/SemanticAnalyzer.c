@@ -137,6 +137,8 @@ void executeSemanticAction(SubAutomatonIdentifier originSubAutomaton, SubAutomat
                 // Evaluate expression
                 case cmndCloseParenthesis:
                     if (originState == 11 || originState == 12 || originState == 16) evaluateExpression(eetEndOfExpression);
+                    // For after step
+                    else if (originState == 24) forStep();
                     break;
                     
                 // While
@@ -159,6 +161,17 @@ void executeSemanticAction(SubAutomatonIdentifier originSubAutomaton, SubAutomat
                     endWhileCommand();
                     break;
                     
+                // For after initialization and after condition
+                case cmndSemiColon:
+                    if (originState == 19) forCondition();
+                    else if (originState == 21) forTest();
+                    break;
+                    
+                // End for
+                case cmndEndfor:
+                    endForCommand();
+                    break;
+                    
                 // Scan
                 case cmndScan:
                     newOperator(oprScan);
@@ -183,9 +196,24 @@ void executeSemanticAction(SubAutomatonIdentifier originSubAutomaton, SubAutomat
         case saiATTR:
             switch (terminal) {
                     
-                // Operand or function call
+                // Operand or function call, or struct field of the operand
                 case attrIdentifier:
                     if (originState == 0) newOperandOrFunctionCall(token->value.intValue);
+                    else if (originState == 3) accessStructField(token->value.intValue);
+                    break;
+                    
+                // Array index of the operand
+                case attrOpenBrackets:
+                    if (originState == 1 || originState == 8) openArrayIndex();
+                    break;
+                    
+                case attrCloseBrackets:
+                    if (originState == 6) closeArrayIndex();
+                    break;
+                    
+                // Arguments of a function call: evaluated before the call, as in an expression
+                case attrOpenParenthesis:
+                    if (originState == 1) newOperator(oprOpenParenthesis);
                     break;
                     
                 // Evaluate expression
@@ -247,9 +275,9 @@ void executeSemanticAction(SubAutomatonIdentifier originSubAutomaton, SubAutomat
             switch (terminal) {
                 case atomOpenParenthesis: if (originState == 0 || originState == 2) newOperator(oprOpenParenthesis); break;
                 case atomCloseParenthesis: evaluateExpression(eetCloseParenthesis); break;
-                case atomInteger:
-                    if (originState == 0) newOperand(opdtInteger, token->value.intValue);
-                    else accessArrayDimension(token->value.intValue); break;
+                case atomInteger: newOperand(opdtInteger, token->value.intValue); break;
+                case atomOpenBrackets: openArrayIndex(); break;
+                case atomCloseBrackets: closeArrayIndex(); break;
                 case atomCharacter: newOperand(opdtChar, token->value.charValue); break;
                 case atomTrue: newOperand(opdtBoolean, 1); break;
                 case atomFalse: newOperand(opdtBoolean, 0); break;
@@ -295,6 +323,11 @@ void executeSemanticActionAtTheEndOfSubAutomaton(SubAutomatonIdentifier currentS
             evaluateExpression(eetEndOfExpression);
             break;
         
+        case saiATOM:
+            // Array element read
+            loadArrayElement();
+            break;
+            
         case saiEXPR:
             // Function return
             if (returnSubAutomaton == saiCMND && returnState == 1) {
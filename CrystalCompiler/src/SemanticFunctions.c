@@ -14,7 +14,9 @@
 // Variable and parameters counters
 static int cumulativeAddress = 0;
 static int temporaryVariablesCounter = 0;
-static int mainSize = 0;
+
+// Label index of the function (or main) whose code is being recorded
+static int currentFunctionIndex = -1;
 
 // Functions, parameters and variables stacks
 static IntegerStack* symbolStack = NULL;
@@ -30,6 +32,22 @@ static int operatorFunctionIndex = -1;
 static int operandSymbolIndex = -1;
 static int operandSymbolTable = -1;
 static int operandDimensionAccessCount = 0;
+static int operandFirstSlot = 0;
+
+// Array accesses whose index is being evaluated (symbol, symbol table, first slot and dimensions accessed)
+static IntegerStack* arrayAccessStack = NULL;
+
+// Fields of each struct type with their offsets, built when the declaration of the struct ends
+typedef struct StructFieldTable {
+    SymbolTableId symbolTable;
+    int fieldCount;
+    char** fieldNames;
+    int* fieldOffsets;
+    SymbolTableRow** fieldSymbols;
+    struct StructFieldTable* nextTable;
+} StructFieldTable;
+
+static StructFieldTable* structFieldTables = NULL;
 
 
 void pushSymbolTableToStack(SymbolTableId table) {
@@ -137,8 +155,10 @@ void endFunctionDeclaration() {
     // Retrieve function symbol
     functionSymbol = getSymbol(functionSymbolIndex, getSymbolTableParent(functionSymbolTable));
     
-    // Generate function return
-    generateFunctionEnd(functionSymbol->address);
+    // Activation record holds parameters, variables and temporary variables, and at least the return value
+    int activationRecordSize = cumulativeAddress + temporaryVariablesCounter + 1;
+    if (activationRecordSize < 2 + functionSymbol->totalSize) activationRecordSize = 2 + functionSymbol->totalSize;
+    endIntermediateFunction(activationRecordSize, functionSymbol->totalSize);
     
     // Notify lexical analyzer
     setLexicalAnalyzerSymbolTable(symbolTableStack->integer);
@@ -150,8 +170,13 @@ void beginFunctionExecution() {
     // Retrieve function symbol from the symbol table
     SymbolTableRow* function = getSymbol(symbolStack->integer, getSymbolTableParent(symbolTableStack->integer));
     
-    // Generate new function.
-    function->address = generateFunctionDeclaration(function->symbol, cumulativeAddress);
+    // Start recording the function code
+    function->address = beginIntermediateFunction(function->symbol, 0);
+    currentFunctionIndex = function->address;
+    
+    // Size of the first parameter, if any
+    SymbolTableRow* firstParameter = getSymbol(0, function->symbolTable);
+    if (firstParameter != NULL && firstParameter->category == scParameter) getIntermediateFunction(function->address)->firstParameterSize = firstParameter->totalSize;
     
     // Reset expression evaluation stacks
     operandStack = NULL;
@@ -161,14 +186,18 @@ void beginFunctionExecution() {
 
 void functionReturn() {
     
+    Operand poppedOperand;
     Operand* returnValue = NULL;
     
     if (operandStack != NULL) {
-        Operand poppedOperand = popOperandFromStack(&operandStack);
+        poppedOperand = popOperandFromStack(&operandStack);
         returnValue = &poppedOperand;
     }
     
-    generateFunctionReturn(returnValue);
+    // Retrieve function symbol to get the size of the returned value
+    SymbolTableRow* function = getSymbol(symbolStack->integer, getSymbolTableParent(symbolTableStack->integer));
+    
+    appendFunctionReturn(returnValue, function->totalSize);
     
 }
 
@@ -215,6 +244,31 @@ void endStructDeclaration() {
     // Iterate over all struct fields to retrieve struct total size.
     for (structField = getSymbol(0, structSymbolTable); structField != NULL; structField = structField->nextRow) structSymbol->totalSize += structField->totalSize;
     
+    // Field offset table, so field accesses do not search the symbol tables
+    StructFieldTable* fieldTable = malloc(sizeof(StructFieldTable));
+    fieldTable->symbolTable = structSymbolTable;
+    fieldTable->fieldCount = 0;
+    for (structField = getSymbol(0, structSymbolTable); structField != NULL && structField->symbol != NULL; structField = structField->nextRow) fieldTable->fieldCount++;
+    fieldTable->fieldNames = malloc(fieldTable->fieldCount * sizeof(char*));
+    fieldTable->fieldOffsets = malloc(fieldTable->fieldCount * sizeof(int));
+    fieldTable->fieldSymbols = malloc(fieldTable->fieldCount * sizeof(SymbolTableRow*));
+    for (int i = 0; i < fieldTable->fieldCount; i++) {
+        structField = getSymbol(i, structSymbolTable);
+        fieldTable->fieldNames[i] = structField->symbol;
+        fieldTable->fieldOffsets[i] = structField->address;
+        fieldTable->fieldSymbols[i] = structField;
+    }
+    fieldTable->nextTable = structFieldTables;
+    structFieldTables = fieldTable;
+    
+}
+
+// Returns the index of the field in the table of the struct, or -1 if the struct has no such field
+static int findStructField(StructFieldTable* fieldTable, char* name) {
+    for (int i = 0; i < fieldTable->fieldCount; i++) {
+        if (strcmp(fieldTable->fieldNames[i], name) == 0) return i;
+    }
+    return -1;
 }
 
 void newVariableDeclaration(int symbolIndex) {
@@ -231,9 +285,6 @@ void newVariableDeclaration(int symbolIndex) {
     // Push symbol to stack.
     pushIntegerToStack(&symbolStack, symbolIndex);
     
-    // Increment main size
-    mainSize++;
-    
 }
 
 // Array declration: Variable or parameter name already read, on the top of the stack
@@ -279,11 +330,22 @@ void setSymbolSizeAndAddress(int retrievingParameters) {
         
     }
     
-    // Multiply total size by array dimensions, if any.
+    // Multiply total size by array dimensions, if any, and precompute the stride of each dimension
     if (symbol->dimensionSizes != NULL) {
+        
+        int stride;
+        
         for (int i = 0; i < integerListLength(symbol->dimensionSizes); i++) {
             symbol->totalSize *= getIntegerFromList(symbol->dimensionSizes, i);
         }
+        
+        stride = symbol->totalSize;
+        for (int i = 0; i < integerListLength(symbol->dimensionSizes); i++) {
+            int dimensionSize = getIntegerFromList(symbol->dimensionSizes, i);
+            if (dimensionSize > 0) stride /= dimensionSize;
+            pushIntegerToList(&symbol->dimensionStrides, stride);
+        }
+        
     }
     
     // Define parameter category if symbol is a parameter
@@ -309,13 +371,12 @@ void mainDeclaration() {
     // Reset counters
     cumulativeAddress = 2;
     temporaryVariablesCounter = -1;
-    mainSize = 0;
 }
 
 void beginMainExecution() {
 
-    // Generate main
-    generateMain();
+    // Start recording main code
+    currentFunctionIndex = beginIntermediateFunction("main", 1);
     
     // Reset expression evaluation stacks
     operandStack = NULL;
@@ -324,7 +385,35 @@ void beginMainExecution() {
 }
 
 void endMain() {
-    generateMainEnd(mainSize);
+    
+    // Main's activation record holds its variables and all of its temporary variables
+    endIntermediateFunction(cumulativeAddress + temporaryVariablesCounter + 1, 0);
+    
+    // Functions that are not part of a cycle of the call graph can never be active twice at the same time,
+    // so their activation records can be allocated statically
+    for (IntermediateFunction* function = getIntermediateFunctions(); function != NULL; function = function->nextFunction) {
+        if (!function->isMain) function->hasStaticActivationRecord = !isRecursiveFunction(function->index);
+        
+        // Static activation records already pass values through their slots
+        function->usesLightCallingConvention = compilerOptions.lightCalls && !function->hasStaticActivationRecord && function->returnValueSize <= 1;
+    }
+    
+    // Optimize and generate code for the whole program
+    optimizeProgram(getIntermediateFunctions());
+    updateCallGraph(getIntermediateFunctions());
+    memoizeFunctions(getIntermediateFunctions());
+    
+    // Interprocedural facts of the optimized program, kept with the function symbols (the functions removed as
+    // dead code have none)
+    findPureFunctions(getIntermediateFunctions());
+    for (int index = 0; getSymbol(index, 0) != NULL; index++) {
+        SymbolTableRow* function = getSymbol(index, 0);
+        if (function->category == scFunction && getIntermediateFunction(function->address) != NULL) summarizeFunction(function->address, &function->summary);
+    }
+    if (compilerOptions.dumpCallGraph) dumpCallGraph(getIntermediateFunctions());
+    
+    generateProgram(getIntermediateFunctions());
+    
 }
 
 void evaluateNextOperation() {
@@ -353,16 +442,15 @@ void evaluateNextOperation() {
             
             while (parameterSymbol->category == scParameter) {
                 Operand parameter = popOperandFromStack(&parameters);
-                generatePassingParameter(parameter, parameterSymbol->address, parameterSymbol->totalSize);
+                appendPassingParameter(parameter, functionSymbol->address, parameterSymbol->address, parameterSymbol->totalSize);
                 parameterId++;
                 parameterSymbol = getSymbol(parameterId, functionSymbolTable);
             }
             
             temporaryVariablesCounter++;
             
-            generateFunctionCall(functionSymbol->address, cumulativeAddress + temporaryVariablesCounter, functionSymbol->totalSize);
-            
-            generateNewTemporaryVariable();
+            appendFunctionCall(functionSymbol->address, cumulativeAddress + temporaryVariablesCounter, functionSymbol->totalSize);
+            addCallGraphEdge(currentFunctionIndex, functionSymbol->address);
             
             Operand result = { opdtTemporary, functionSymbol->type, cumulativeAddress + temporaryVariablesCounter };
             pushOperandToStack(&operandStack, result);
@@ -377,12 +465,8 @@ void evaluateNextOperation() {
             
             while (inputVariables != NULL) {
                 Operand input = popOperandFromStack(&inputVariables);
-                if (input.operandSymbolType == stString) {
-                    generateStringScan(input.value);
-                } else if (input.operandSymbolType == stInt) {
-                    generateIntScan(input.value);
-                } else if (input.operandSymbolType == stBoolean) {
-                    generateBooleanScan(input.value);
+                if (input.operandSymbolType == stString || input.operandSymbolType == stInt || input.operandSymbolType == stBoolean) {
+                    appendScan(input.operandSymbolType, input.value);
                 }
                 else {
                     // Error: invalid type
@@ -399,9 +483,9 @@ void evaluateNextOperation() {
             
             while (outputOperands != NULL) {
                 Operand output = popOperandFromStack(&outputOperands);
-                if (output.type == opdtString || output.operandSymbolType == stString) generateStringPrint(output);
-                else if (output.type == opdtInteger || output.operandSymbolType == stInt) generateIntPrint(output);
-                else if (output.type == opdtBoolean || output.operandSymbolType == stBoolean) generateBooleanPrint(output);
+                if (output.type == opdtString || output.operandSymbolType == stString) appendPrint(stString, output);
+                else if (output.type == opdtInteger || output.operandSymbolType == stInt) appendPrint(stInt, output);
+                else if (output.type == opdtBoolean || output.operandSymbolType == stBoolean) appendPrint(stBoolean, output);
             }
             
         }
@@ -417,7 +501,8 @@ void evaluateNextOperation() {
                 // Pop left operand
                 leftOperand = popOperandFromStack(&operandStack);
                 
-                if (leftOperand.type == opdtVariable) generateAttribution(leftOperand, rightOperand);
+                if (leftOperand.type == opdtVariable) appendAttribution(leftOperand, rightOperand);
+                else if (leftOperand.type == opdtElement) appendStore(leftOperand, rightOperand);
                 else {
                     // Error: invalid operation
                 }
@@ -433,9 +518,7 @@ void evaluateNextOperation() {
                     leftOperand = popOperandFromStack(&operandStack);
                     
                     // If both operands are not temporary variables, create a new temporary variable
-                    temporaryVariablesCounter++;
-                    if (leftOperand.type != opdtTemporary && rightOperand.type != opdtTemporary) generateNewTemporaryVariable();
-                    else temporaryVariablesCounter --;
+                    if (leftOperand.type != opdtTemporary && rightOperand.type != opdtTemporary) temporaryVariablesCounter++;
                     
                     // Generate code
                     switch (operator) {
@@ -444,7 +527,7 @@ void evaluateNextOperation() {
                         case oprSubtract:
                         case oprMultiply:
                         case oprDivide:
-                            generateArithmeticOperation(operator, leftOperand, rightOperand,  cumulativeAddress + temporaryVariablesCounter);
+                            appendOperation(icArithmetic, operator, leftOperand, rightOperand, cumulativeAddress + temporaryVariablesCounter);
                             resultType = stInt;
                             break;
                             
@@ -453,13 +536,15 @@ void evaluateNextOperation() {
                         case oprSmallerOrEqualThan:
                         case oprBiggerThan:
                         case oprBiggerOrEqualThan:
-                            generateRelationalComparison(operator, leftOperand, rightOperand, cumulativeAddress + temporaryVariablesCounter);
+                        case oprEquals:
+                        case oprDifferent:
+                            appendOperation(icRelational, operator, leftOperand, rightOperand, cumulativeAddress + temporaryVariablesCounter);
                             resultType = stBoolean;
                             break;
                             
                         case oprLogicAnd:
                         case oprLogicOr:
-                            generateLogicalOperation(operator, leftOperand, rightOperand, cumulativeAddress + temporaryVariablesCounter);
+                            appendOperation(icLogical, operator, leftOperand, rightOperand, cumulativeAddress + temporaryVariablesCounter);
                             resultType = stBoolean;
                             break;
                             
@@ -474,9 +559,7 @@ void evaluateNextOperation() {
                 else {
                     
                     // If operand is not a temporary variable, create a new temporary variable.
-                    temporaryVariablesCounter++;
-                    if (rightOperand.type != opdtTemporary) generateNewTemporaryVariable();
-                    else temporaryVariablesCounter --;
+                    if (rightOperand.type != opdtTemporary) temporaryVariablesCounter++;
                     
                     // Generate code
                     switch (operator) {
@@ -527,6 +610,12 @@ void evaluateExpression(ExpressionEvaluationTrigger trigger) {
     
 }
 
+// Evaluates the operators that bind at least as tightly as the given one (left associativity), without going
+// past an open parenthesis, an attribution or an expression list
+static void evaluatePrecedingOperators(Operator operator) {
+    while (operatorStack != NULL && operatorStack->operator != oprOpenParenthesis && operatorStack->operator != oprEqualSign && operatorStack->operator != oprComma && OPERATOR_PRECEDENCE[operator] <= OPERATOR_PRECEDENCE[operatorStack->operator]) evaluateNextOperation();
+}
+
 // Push an operator to the stack
 void newOperator(Operator operator) {
     
@@ -535,8 +624,11 @@ void newOperator(Operator operator) {
         if (operatorStack != NULL) {
             // Equal sign: if it comes after ! or > or <, push the right operator
             switch (operatorStack->operator) {
+                // Second sign of ==: the first one was pushed as an attribution, so the operators before the
+                // comparison still have to be evaluated
                 case oprEqualSign:
                     popOperatorFromStack(&operatorStack, &operatorFunctionIndex);
+                    evaluatePrecedingOperators(oprEquals);
                     pushOperatorToStack(&operatorStack, oprEquals, -1);
                     break;
                 case oprBiggerThan:
@@ -561,7 +653,7 @@ void newOperator(Operator operator) {
         else {
             
             // Verify precedence rule
-            if (operatorStack != NULL && operatorStack->operator != oprOpenParenthesis && operatorStack->operator != oprEqualSign && OPERATOR_PRECEDENCE[operator] < OPERATOR_PRECEDENCE[operatorStack->operator]) evaluateExpression(eetPrecedenceViolation);
+            evaluatePrecedingOperators(operator);
             
             // Push operator to the stack
             pushOperatorToStack(&operatorStack, operator, -1);
@@ -607,6 +699,7 @@ void newOperand(OperandType type, int value) {
         operand.operandSymbolType = symbol->type;
         operandSymbolIndex = value;
         operandSymbolTable = symbolTableStack->integer;
+        operandFirstSlot = symbol->address;
         operandDimensionAccessCount = 0;
     } else {
         operand.value = value;
@@ -630,65 +723,196 @@ void newStringOperand(char* value) {
     
 }
 
+// Number of slots between two consecutive indexes of the next dimension accessed
+static int getDimensionStride() {
+    
+    SymbolTableRow* variableSymbol = getSymbol(operandSymbolIndex, operandSymbolTable);
+    
+    // Error: more indexes than dimensions
+    if (operandDimensionAccessCount >= integerListLength(variableSymbol->dimensionStrides)) return 0;
+    
+    return getIntegerFromList(variableSymbol->dimensionStrides, operandDimensionAccessCount);
+    
+}
+
+// Number of indexes of the next dimension accessed (0 if there are more indexes than dimensions)
+static int getDimensionSize() {
+    
+    SymbolTableRow* variableSymbol = getSymbol(operandSymbolIndex, operandSymbolTable);
+    
+    if (operandDimensionAccessCount >= integerListLength(variableSymbol->dimensionSizes)) return 0;
+    
+    return getIntegerFromList(variableSymbol->dimensionSizes, operandDimensionAccessCount);
+    
+}
+
+// Field of a struct operand: nested fields add up to a single offset, known at compile time
 void accessStructField(int symbolIndex) {
     
-    SymbolTableRow* fieldSymbol = getSymbol(symbolIndex, symbolTableStack->integer);
     SymbolTableRow* variableSymbol = getSymbol(operandSymbolIndex, operandSymbolTable);
+    StructFieldTable* fieldTable;
+    SymbolTableRow* fieldSymbol;
+    int field;
+    
+    for (fieldTable = structFieldTables; fieldTable != NULL && fieldTable->symbolTable != variableSymbol->symbolTable; fieldTable = fieldTable->nextTable);
     
-    fieldSymbol = lookupSymbol(fieldSymbol->symbol, variableSymbol->symbolTable);
+    field = fieldTable != NULL ? findStructField(fieldTable, getSymbol(symbolIndex, symbolTableStack->integer)->symbol) : -1;
+    if (field < 0) return; // Error: not a field of the struct
+    fieldSymbol = fieldTable->fieldSymbols[field];
+    
+    // Element address known at run time: the field offset is added to its constant part
+    if (operandStack->operand.type == opdtElement) offsetElementAddress(operandStack->operand, fieldTable->fieldOffsets[field]);
+    else operandStack->operand.value += fieldTable->fieldOffsets[field];
+    operandStack->operand.operandSymbolType = fieldSymbol->type;
     
-    operandStack->operand.value += fieldSymbol->address;
     operandSymbolIndex = fieldSymbol->id;
     operandSymbolTable = variableSymbol->symbolTable;
+    operandFirstSlot = operandStack->operand.value;
     operandDimensionAccessCount = 0;
     
 }
 
 void accessArrayDimension(int index) {
     
-    int cumulativePosition = index;
-    SymbolTableRow* variableSymbol = getSymbol(operandSymbolIndex, operandSymbolTable);
-    for (int i = operandDimensionAccessCount + 1; i < integerListLength(variableSymbol->dimensionSizes); i++) {
-        cumulativePosition *= getIntegerFromList(variableSymbol->dimensionSizes, i);
+    int cumulativePosition = index * getDimensionStride();
+    Operand constantIndex = { opdtInteger, stInt, index };
+    
+    // Constant index checked at compile time: only an index out of bounds leaves a check, which stops the program
+    // before the element (replaced by the first one of the dimension) is accessed
+    if (compilerOptions.boundsCheck && (index < 0 || index >= getDimensionSize())) {
+        appendBoundsCheck(constantIndex, getDimensionSize());
+        cumulativePosition = 0;
     }
-    if (variableSymbol->type > scStruct) {
-        SymbolTableRow* structSymbol = getSymbol(variableSymbol->type - stStruct, 0);
-        cumulativePosition *= structSymbol->totalSize;
+    
+    if (operandStack->operand.type == opdtElement) offsetElementAddress(operandStack->operand, cumulativePosition);
+    else operandStack->operand.value += cumulativePosition;
+    operandDimensionAccessCount++;
+    
+}
+
+// Index known at run time: the operand becomes the address of the element, computed into a temporary variable
+static void accessArrayDimensionAtRunTime(Operand index) {
+    
+    Operand* operand = &operandStack->operand;
+    Operand address = { opdtTemporary, stInt, 0 };
+    Operand offset = { opdtTemporary, stInt, 0 };
+    Operand stride = { opdtInteger, stInt, 2 * getDimensionStride() };
+    
+    if (compilerOptions.boundsCheck) appendBoundsCheck(index, getDimensionSize());
+    
+    // Address of the variable, plus the slots of the dimensions accessed with constant indexes
+    if (operand->type != opdtElement) {
+        SymbolTableRow* variableSymbol = getSymbol(operandSymbolIndex, operandSymbolTable);
+        Operand variable = { opdtVariable, operand->operandSymbolType, operandFirstSlot };
+        temporaryVariablesCounter++;
+        appendAddress(variable, variableSymbol->totalSize, operand->value - operandFirstSlot, cumulativeAddress + temporaryVariablesCounter);
+        operand->type = opdtElement;
+        operand->value = cumulativeAddress + temporaryVariablesCounter;
     }
-    operandStack->operand.value += cumulativePosition;
+    address.value = operand->value;
+    
+    // Index times the size of the dimension in bytes
+    temporaryVariablesCounter++;
+    offset.value = cumulativeAddress + temporaryVariablesCounter;
+    appendOperation(icArithmetic, oprMultiply, index, stride, offset.value);
+    
+    temporaryVariablesCounter++;
+    appendOperation(icArithmetic, oprAdd, address, offset, cumulativeAddress + temporaryVariablesCounter);
+    operand->value = cumulativeAddress + temporaryVariablesCounter;
     operandDimensionAccessCount++;
     
 }
 
+// Array index: the operand being accessed is saved while the index expression is evaluated
+void openArrayIndex() {
+    pushIntegerToStack(&arrayAccessStack, operandSymbolIndex);
+    pushIntegerToStack(&arrayAccessStack, operandSymbolTable);
+    pushIntegerToStack(&arrayAccessStack, operandFirstSlot);
+    pushIntegerToStack(&arrayAccessStack, operandDimensionAccessCount);
+    pushOperatorToStack(&operatorStack, oprOpenParenthesis, -1);
+}
+
+void closeArrayIndex() {
+    
+    Operand index;
+    
+    evaluateExpression(eetCloseParenthesis);
+    index = popOperandFromStack(&operandStack);
+    
+    popIntegerFromStack(&arrayAccessStack, &operandDimensionAccessCount);
+    popIntegerFromStack(&arrayAccessStack, &operandFirstSlot);
+    popIntegerFromStack(&arrayAccessStack, &operandSymbolTable);
+    popIntegerFromStack(&arrayAccessStack, &operandSymbolIndex);
+    
+    if (index.type == opdtInteger || index.type == opdtChar) accessArrayDimension(index.value);
+    else accessArrayDimensionAtRunTime(index);
+    
+}
+
+// End of an atom: an element whose address is known at run time is read into a temporary variable
+void loadArrayElement() {
+    
+    if (operandStack == NULL || operandStack->operand.type != opdtElement) return;
+    
+    Operand element = popOperandFromStack(&operandStack);
+    
+    temporaryVariablesCounter++;
+    appendLoad(element, cumulativeAddress + temporaryVariablesCounter);
+    
+    element.type = opdtTemporary;
+    element.value = cumulativeAddress + temporaryVariablesCounter;
+    pushOperandToStack(&operandStack, element);
+    
+}
+
 
 // IF
 
 void newIfCommand() {
     Operand condition = popOperandFromStack(&operandStack);
-    generateIfCommand(condition);
+    appendIfCommand(condition);
 }
 
 void newElseCommand() {
-    generateElseCommand();
+    appendElseCommand();
 }
 
 void endIfCommand() {
-    generateEndIf();
+    appendEndIf();
 }
 
 // WHILE
 
 void newWhileCommand() {
-    generateWhileCommand();
+    appendWhileCommand();
 }
 
 void whileTest() {
     Operand condition = popOperandFromStack(&operandStack);
-    generateWhileTest(condition);
+    appendWhileTest(condition);
 }
 
 void endWhileCommand() {
-    generateEndWhile();
+    appendEndWhile();
+}
+
+// FOR
+
+void forCondition() {
+    appendForCondition();
+}
+
+void forTest() {
+    evaluateExpression(eetEndOfExpression);
+    appendForTest(popOperandFromStack(&operandStack));
+}
+
+void forStep() {
+    appendForStep();
+}
+
+void endForCommand() {
+    appendEndFor();
 }
 
 void freeSemanticAnalyzerInternalStructures() {
@@ -697,6 +921,16 @@ void freeSemanticAnalyzerInternalStructures() {
     if (typeStack != NULL) free(typeStack);
     if (operandStack != NULL) free(operandStack);
     if (operatorStack != NULL) free(operatorStack);
+    if (arrayAccessStack != NULL) free(arrayAccessStack);
+    
+    while (structFieldTables != NULL) {
+        StructFieldTable* fieldTable = structFieldTables;
+        structFieldTables = fieldTable->nextTable;
+        free(fieldTable->fieldNames);
+        free(fieldTable->fieldOffsets);
+        free(fieldTable->fieldSymbols);
+        free(fieldTable);
+    }
 }
 
 
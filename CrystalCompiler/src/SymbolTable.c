@@ -31,6 +31,7 @@ int initializeNewSymbolTable() {
     SymbolTableRow* newSymbolTableFirstRow = malloc(sizeof(SymbolTableRow));
     newSymbolTableFirstRow->symbol = NULL;
     newSymbolTableFirstRow->dimensionSizes = NULL;
+    newSymbolTableFirstRow->dimensionStrides = NULL;
     newSymbolTableFirstRow->nextRow = NULL;
     newSymbolTableFirstRow->category = scUndefined;
     
@@ -141,6 +142,7 @@ int addNewSymbolIfNonexistent(char* symbol, SymbolTableId symbolTableId) {
         newRow->symbol = malloc(sizeof(*symbol));
         newRow->id = index;
         newRow->dimensionSizes = NULL;
+        newRow->dimensionStrides = NULL;
         newRow->category = scUndefined;
         strcpy(newRow->symbol, symbol);
         
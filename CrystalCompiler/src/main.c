@@ -9,14 +9,17 @@
 
 #include <stdio.h>
 #include "SyntacticAnalyzer.h"
+#include "CompilerOptions.h"
 
 int main(int argc, const char * argv[]) {
     
-    // Verify if both input and output files have been provided.
-    if (argc < 2) return -1;
+    const char* files[2];
     
-    // Compile the source code (first argument) to output file (second argument).
-    compile(argv[1], argv[2]);
+    // Verify if both input and output files have been provided, and read the compiler options.
+    if (!parseCompilerOptions(argc, argv, files)) return -1;
+    
+    // Compile the source code (first file) to output file (second file).
+    compile(files[0], files[1]);
     
     return 0;
     
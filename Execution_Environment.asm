@@ -29,10 +29,15 @@ evval   >
 evoffs  >
 evsign  >
 evtemp  >
+evarg   >
+evret   >
 ercad   >
 erwrt   >
 errd    >
 ercpb   >
+erbnd   >
+ekldcd  >
+ekwrcd  >
 
 ; Export stack variables and sub-routines
 svbptr  >
@@ -58,8 +63,19 @@ pbrkl   >
 
         &  /0000
 
-; Jumps to the main, start code execution
-start   JP main
+; Checks the size of the environment, then jumps to the main, start code execution.
+; The compiler sizes the stack from the memory left after the environment, which
+; takes evsize bytes: ENVIRONMENT_WORDS in CodeGenerator.c must be updated with it.
+; If the environment changed without it, the execution halts here.
+start   LV  start
+        MM  evtemp
+        LV  evend
+        +   nk2
+        -   evtemp
+        -   evsize
+        JZ  main
+        HM  start
+evsize  K   /0298
  
 ; ---------------------------------------------
 ;   NUMERICAL CONSTANTS (nk)
@@ -86,6 +102,15 @@ skUE    K  'ue
 skFA    K  'fa
 skLS    K  'ls
 skE     K  'e
+skIN    K  'In
+skDE    K  'de
+skXS    K  /7820
+skOU    K  'ou
+skTS    K  /7420
+skOF    K  'of
+skSB    K  /2062
+skND    K  'nd
+skS     K  's
 
 ; ---------------------------------------------
 ;   ENVIRONMENT CONSTANTS (ek)
@@ -104,6 +129,10 @@ evoffs  K  /0
 evsign  K  /0
 evtemp  K  /0
 
+; Light calling convention: first argument and returned value
+evarg   K  /0
+evret   K  /0
+
 ; ---------------------------------------------
 ;   ENVIRONMENT SUB-ROUTINES (er)
 ; ---------------------------------------------
@@ -209,6 +238,35 @@ ercpb4  K  /0        ; Write value to the new address
         JP ercpb1    ; Loop
 ercpb2  RS ercpb     ; Return
 
+; ENVIRONMENT SUB-ROUTINE: bnd
+;
+; Stop the execution when an array index is out of bounds (code compiled
+; with --bounds-check jumps here). It does not return.
+;
+erbnd   LD skIN      ; Print "Index out of bounds"
+        PD /100
+        LD skDE
+        PD /100
+        LD skXS
+        PD /100
+        LD skOU
+        PD /100
+        LD skTS
+        PD /100
+        LD skOF
+        PD /100
+        LD skSB
+        PD /100
+        LD skOU
+        PD /100
+        LD skND
+        PD /100
+        LD skS
+        PD /100
+        LD skbrkl
+        PD /100
+        HM erbnd     ; Error: index out of bounds
+
 
 ; ---------------------------------------------
 ;    STACK VARIABLES (sv)
@@ -226,7 +284,7 @@ svsize  K  /0        ; Size of the activation record
 ; Push a new activation record to the stack.
 ;
 ;   Parameters:
-;       svsize: Size of the activation record to be pushed
+;       svsize: Size of the activation record to be pushed (in number of addresses)
 ;
 ;   Result:
 ;       svbptr and svsptr values updated
@@ -245,7 +303,7 @@ srpsa   K   /0
         +   nk2
         MM  svbptr
         LD  svsptr    ; Update stack pointer
-        +   nk4
+        +   svsize
         +   svsize
         MM  svsptr
         RS  srpsa     ; Return
@@ -532,4 +590,7 @@ pbrkl   K   /0000
         PD  /100
         RS  pbrkl
 
+; End of the environment (its last word)
+evend   K   /0000
+
         #  start  
\ No newline at end of file